@@ -5,11 +5,12 @@ Code responsible with directly interacting with GDB
 """
 
 import gdb
-import time
 import threading
 
+from oidscripts import regions
 from oidscripts import sysinfo
 from oidscripts.debuggers.interfaces import BridgeInterface
+from oidscripts.debuggers.requestqueue import RequestQueue
 from oidscripts.events import BridgeEventHandlerInterface
 from oidscripts.logger import log
 
@@ -23,11 +24,17 @@ class GdbBridge(BridgeInterface):
         self._commands = dict(plot=PlotterCommand(self))
         self._event_handler = None  # type: BridgeEventHandlerInterface
 
-        self._pending_requests = []
-        self._lock = threading.Lock()
+        self._requests = RequestQueue()
+
+        # Observable member names of each struct type, and observable symbols
+        # declared in each block. Neither changes until objfiles are reloaded.
+        self._observable_members = {}
+        self._block_symbols = {}
 
         gdb.events.stop.connect(self._event_stop_handler)
         gdb.events.exited.connect(self._event_exit_handler)
+        gdb.events.new_objfile.connect(self._event_objfiles_changed)
+        gdb.events.clear_objfiles.connect(self._event_objfiles_changed)
 
         event_loop_thread = threading.Thread(target=self.event_loop)
         event_loop_thread.daemon = True
@@ -35,25 +42,19 @@ class GdbBridge(BridgeInterface):
 
     def event_loop(self):
         while True:
-            requests_to_process = []
-            with self._lock:
-                requests_to_process = self._pending_requests
-                self._pending_requests = []
-
-            while requests_to_process:
-                callback = requests_to_process.pop(0)
+            for callback in self._requests.wait():
                 gdb.post_event(callback)
 
-            time.sleep(0.1)
-
     def queue_request(self, callable_request):
-        with self._lock:
-            self._pending_requests.append(callable_request)
+        self._requests.put(callable_request)
+
+    def watch_descriptors(self, descriptors, callable_request):
+        self._requests.watch(descriptors, callable_request)
 
     def get_backend_name(self):
         return 'gdb'
 
-    def get_buffer_metadata(self, variable):
+    def get_buffer_metadata(self, variable, region=None, read_contents=True):
         picked_obj = gdb.parse_and_eval(variable)
 
         buffer_metadata = self._type_bridge.get_buffer_metadata(
@@ -63,38 +64,145 @@ class GdbBridge(BridgeInterface):
             # Invalid symbol for current frame
             return None
 
-        bufsize = sysinfo.get_buffer_size(
-            buffer_metadata['height'],
-            buffer_metadata['channels'],
-            buffer_metadata['type'],
-            buffer_metadata['row_stride']
-        )
+        bufsize = regions.get_read_size(buffer_metadata)
 
         # Check if buffer is initialized
         if buffer_metadata['pointer'] == 0x0:
             raise RuntimeError('Invalid null buffer pointer')
         if bufsize == 0:
             raise ValueError('Invalid buffer of zero bytes')
-        elif bufsize >= sysinfo.get_available_memory() / 10:
-            raise MemoryError('Invalid buffer size larger than available memory')
+
+        # Buffers too large to be read whole are sent as an overview, and the
+        # window requests the regions it displays
+        memory_budget = sysinfo.get_available_memory() / 10
+        if region is None and bufsize >= memory_budget:
+            region = regions.get_overview_region(buffer_metadata, memory_budget)
 
         # Check if buffer is valid. If it isn't, this function will throw an
-        # exception
-        gdb.execute('x ' + str(int(buffer_metadata['pointer'].cast(gdb.lookup_type('long')))))
+        # exception. Pointers decoded from a header are already addresses.
+        address = buffer_metadata['pointer']
+        if not isinstance(address, int):
+            address = int(address.cast(gdb.lookup_type('long')))
+        gdb.execute('x ' + str(address))
 
-        inferior = gdb.selected_inferior()
         buffer_metadata['variable_name'] = variable
-        buffer_metadata['pointer'] = inferior.read_memory(
-            buffer_metadata['pointer'], bufsize)
+        buffer_metadata['address'] = address
+        if region is not None:
+            buffer_metadata['region'] = tuple(region)
+
+        if read_contents:
+            self.read_buffer_contents(buffer_metadata)
 
         return buffer_metadata
 
+    def read_buffer_contents(self, buffer_metadata):
+        inferior = gdb.selected_inferior()
+        address = buffer_metadata['address']
+        if 'region' in buffer_metadata:
+            buffer_metadata['pointer'] = regions.read_region(
+                inferior.read_memory, address, buffer_metadata,
+                buffer_metadata['region'])
+        else:
+            buffer_metadata['pointer'] = regions.read_buffer(
+                inferior.read_memory, address, buffer_metadata)
+
+    def get_inferior_pid(self):
+        inferior = gdb.selected_inferior()
+
+        # Connections are only exposed by recent versions of GDB. Remote
+        # targets and core files have connections of other types.
+        connection = getattr(inferior, 'connection', None)
+        if inferior.pid <= 0 or connection is None or \
+                connection.type != 'native':
+            return None
+
+        return inferior.pid
+
+    @staticmethod
+    def _get_struct_type(value_type):
+        value_type = value_type.strip_typedefs()
+        if value_type.code in (gdb.TYPE_CODE_PTR, gdb.TYPE_CODE_REF):
+            value_type = value_type.target().strip_typedefs()
+
+        return value_type
+
+    @staticmethod
+    def _find_field(struct_type, name):
+        """
+        Find the offset and type of the member 'name' of 'struct_type',
+        looking into base classes and anonymous unions as well. Returns None
+        if it is not found or is a bit field.
+        """
+        for field in struct_type.fields():
+            # Static members have no position
+            if not hasattr(field, 'bitpos') or field.bitsize != 0:
+                continue
+
+            if field.name == name:
+                return field.bitpos // 8, field.type
+
+            if field.is_base_class or not field.name:
+                found = GdbBridge._find_field(field.type.strip_typedefs(),
+                                              name)
+                if found is not None:
+                    return field.bitpos // 8 + found[0], found[1]
+
+        return None
+
+    def get_header_layout(self, picked_obj, header_fields):
+        struct_type = GdbBridge._get_struct_type(picked_obj.type)
+
+        layout = {}
+        for key, path in header_fields.items():
+            offset = 0
+            field_type = struct_type
+            for step in path:
+                field_type = field_type.strip_typedefs()
+                if isinstance(step, int):
+                    if field_type.code != gdb.TYPE_CODE_ARRAY:
+                        return None
+                    field_type = field_type.target()
+                    offset += step * field_type.sizeof
+                else:
+                    found = GdbBridge._find_field(field_type, step)
+                    if found is None:
+                        return None
+                    offset += found[0]
+                    field_type = found[1]
+
+            field_type = field_type.strip_typedefs()
+            is_signed = field_type.code == gdb.TYPE_CODE_INT and \
+                not str(field_type).startswith('unsigned')
+            layout[key] = (offset, field_type.sizeof, is_signed)
+
+        endianness = gdb.execute('show endian', to_string=True)
+        return layout, '<' if 'little' in endianness else '>'
+
+    def get_object_address(self, picked_obj):
+        value_type = picked_obj.type.strip_typedefs()
+        if value_type.code == gdb.TYPE_CODE_PTR:
+            return int(picked_obj)
+        if value_type.code == gdb.TYPE_CODE_REF:
+            picked_obj = picked_obj.referenced_value()
+
+        address = picked_obj.address
+        return int(address) if address is not None else None
+
+    def read_memory(self, address, size):
+        return gdb.selected_inferior().read_memory(address, size)
+
     def _event_stop_handler(self, event):
         self._event_handler.stop_handler()
 
     def _event_exit_handler(self, event):
         self._event_handler.exit_handler()
 
+    def _event_objfiles_changed(self, event):
+        self._observable_members.clear()
+        self._block_symbols.clear()
+        self._type_bridge.clear_type_inspector_cache()
+        self._type_bridge.clear_header_plans()
+
     def register_event_handlers(self, event_handler):
         self._event_handler = event_handler
         self._commands['plot'].set_command_listener(event_handler.plot_handler)
@@ -104,44 +212,79 @@ class GdbBridge(BridgeInterface):
         typename_pointer_obj = typename_obj.pointer()
         return gdb_object.cast(typename_pointer_obj)
 
-    def _get_observable_children_members(self, symbol, output_set, parent_name=''):
-        if not parent_name:
-            parent_name = symbol.name
-
-        if gdb.TYPE_CODE_STRUCT == symbol.type.code:
-            for field in symbol.type.fields():
-                # Check if already observable
-                complete_symbol_name = f"{parent_name}.{field.name}"
-                if self._type_bridge.is_symbol_observable(field, complete_symbol_name):
-                    output_set.add(complete_symbol_name)
-
-                # Check if there's a possible observable child
-                elif gdb.TYPE_CODE_STRUCT == field.type.code:
-                    self._get_observable_children_members(field, output_set, complete_symbol_name)
+    def _get_observable_members(self, struct_type):
+        """
+        Get the names of the observable members of 'struct_type', including
+        members of nested structs as 'member.nested_member'
+        """
+        type_name = str(struct_type)
+        members = self._observable_members.get(type_name)
+        if members is not None:
+            return members
+
+        members = []
+        for field in struct_type.fields():
+            # Check if already observable
+            if self._type_bridge.is_symbol_observable(field, field.name):
+                members.append(field.name)
+
+            # Check if there's a possible observable child
+            elif gdb.TYPE_CODE_STRUCT == field.type.code:
+                members.extend(
+                    f"{field.name}.{member}"
+                    for member in self._get_observable_members(field.type))
+
+        members = tuple(members)
+        self._observable_members[type_name] = members
+        return members
+
+    def _get_block_symbols(self, block):
+        """
+        Get the observable symbols declared in 'block', not including the ones
+        of its superblocks
+        """
+        # Static and global blocks of a compilation unit share their range
+        key = (block.start, block.end, block.is_static, block.is_global)
+        symbols = self._block_symbols.get(key)
+        if symbols is not None:
+            return symbols
+
+        symbols = []
+        for symbol in block:
+            if not (symbol.is_argument or symbol.is_variable):
+                continue
+
+            name = symbol.name
+            symbol_type = symbol.type
+
+            # Check if the symbol is already observable
+            if self._type_bridge.is_symbol_observable(symbol, name):
+                symbols.append(name)
+
+            # Special case to handle 'this', whose members are listed
+            elif name == 'this':
+                if gdb.TYPE_CODE_PTR == symbol_type.code and \
+                        gdb.TYPE_CODE_STRUCT == symbol_type.target().code:
+                    symbols.extend(
+                        f"{name}.{member}" for member in
+                        self._get_observable_members(symbol_type.target()))
+
+            # Check if we have a struct or a class
+            elif gdb.TYPE_CODE_STRUCT == symbol_type.code:
+                symbols.extend(
+                    f"{name}.{member}"
+                    for member in self._get_observable_members(symbol_type))
+
+        symbols = tuple(symbols)
+        self._block_symbols[key] = symbols
+        return symbols
 
     def get_available_symbols(self):
         frame = gdb.selected_frame()
         block = frame.block()
         observable_symbols = set()
         while block is not None:
-            for symbol in block:
-                if symbol.is_argument or symbol.is_variable:
-                    name = symbol.name
-
-                    # Check if the symbol is already observable
-                    if self._type_bridge.is_symbol_observable(symbol, name):
-                        observable_symbols.add(name)
-
-                    # Special case to handle 'this'
-                    elif name == 'this':
-                        this_field = gdb.parse_and_eval(name).dereference().type.fields()
-                        for field in this_field:
-                            self._get_observable_children_members(field, observable_symbols, name)
-
-                    # Check if we have a struct or a class
-                    else:
-                        self._get_observable_children_members(symbol, observable_symbols)
-
+            observable_symbols.update(self._get_block_symbols(block))
             block = block.superblock
 
         return observable_symbols
@@ -27,8 +27,19 @@ class BridgeInterface(object):
         raise __not_implemented_error
 
     @abc.abstractmethod
-    def get_buffer_metadata(self, variable):
-        # type: (str) -> dict
+    def watch_descriptors(self, descriptors, callable_request):
+        # type: (List[int], Callable[[None],bool]) -> None
+        """
+        Request the debugger backend to execute 'callable_request' in its main
+        execution thread whenever any of the file 'descriptors' becomes
+        readable, instead of it being polled. The descriptors keep being
+        watched for as long as 'callable_request' returns True.
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def get_buffer_metadata(self, variable, region=None, read_contents=True):
+        # type: (str, tuple, bool) -> dict
         """
         Given a string defining a variable name, must return the following
         information about it:
@@ -44,6 +55,72 @@ class BridgeInterface(object):
             row_stride:int,
             pixel_layout:str,
         }
+
+        If 'region' is provided as a tuple (x, y, width, height, downsampling),
+        or if the buffer is too large to be read whole, 'pointer' must only hold
+        every downsampling-th row of the region (see regions.py), and the
+        region must be returned as well:
+
+            region:tuple
+
+        The address of the buffer in the debugged process must be returned as
+        well, as an int:
+
+            address:int
+
+        If 'read_contents' is False, the contents are not read and 'pointer'
+        may hold anything: they are either read later with
+        read_buffer_contents, or directly by the native library.
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def read_buffer_contents(self, buffer_metadata):
+        # type: (dict) -> None
+        """
+        Read the contents of a buffer whose metadata was obtained with
+        get_buffer_metadata(..., read_contents=False), and store them as its
+        'pointer'.
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def get_header_layout(self, picked_obj, header_fields):
+        # type: (DebuggerSymbolReference, dict) -> Optional[tuple]
+        """
+        Resolve where the fields of the struct referred to by 'picked_obj' are,
+        from type information only. 'header_fields' maps keys to paths of
+        member names and array indices. Return a tuple (layout, byte_order),
+        where layout maps each key to (offset, size, is_signed) in bytes and
+        byte_order is '<' or '>' for little and big endian targets; or None
+        if any field cannot be resolved (e.g. bit fields).
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def get_object_address(self, picked_obj):
+        # type: (DebuggerSymbolReference) -> Optional[int]
+        """
+        Get the address of the struct referred to by 'picked_obj', which may
+        also be a pointer or a reference to it; None if it is not in memory.
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def read_memory(self, address, size):
+        # type: (int, int) -> memoryview
+        """
+        Read 'size' bytes of the debugged process memory at 'address'.
+        """
+        raise __not_implemented_error
+
+    @abc.abstractmethod
+    def get_inferior_pid(self):
+        # type: () -> Optional[int]
+        """
+        Get the id of the debugged process if it is alive and runs on this
+        machine, so that its memory may be read without the debugger; None
+        otherwise (e.g. remote targets and core files).
         """
         raise __not_implemented_error
 
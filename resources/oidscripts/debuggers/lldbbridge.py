@@ -5,16 +5,24 @@ Code responsible with directly interacting with LLDB
 """
 
 import lldb
-import time
 import threading
 
+from oidscripts import regions
 from oidscripts import sysinfo
 from oidscripts.typebridge import TypeInspectorInterface
 from oidscripts.debuggers.interfaces import BridgeInterface, \
     DebuggerSymbolReference
+from oidscripts.debuggers.requestqueue import RequestQueue
 
 instance = None
 
+# Process plugins that load core files, whose memory cannot be read directly
+CORE_FILE_PLUGINS = ('elf-core', 'mach-o-core', 'minidump')
+
+# LLDB raises no stop events to scripts, so the selected frame is checked for
+# changes at this interval, in seconds. Requests do not wait for it.
+FRAME_CHECK_INTERVAL = 0.1
+
 
 class LldbBridge(BridgeInterface):
     """
@@ -27,13 +35,19 @@ class LldbBridge(BridgeInterface):
         global instance
         instance = self
         self._type_bridge = type_bridge
-        self._pending_requests = []
+        self._requests = RequestQueue()
         self._lock = threading.Lock()
         self._event_queue = []
         self._event_handler = None
         self._last_thread_id = 0
         self._last_frame_idx = 0
 
+        # Observable member chains of each type, and observable symbols of
+        # each scope, for the process and modules they were listed in
+        self._observable_members = {}
+        self._scope_symbols = {}
+        self._symbols_modules_id = None
+
         # Store debugger from the main thread since it isn't available from an event loop.
         self._debugger = lldb.debugger
 
@@ -69,12 +83,9 @@ class LldbBridge(BridgeInterface):
 
     def event_loop(self):
         while True:
-            self._check_frame_modification()
+            requests_to_process = self._requests.wait(FRAME_CHECK_INTERVAL)
 
-            requests_to_process = []
-            with self._lock:
-                requests_to_process = self._pending_requests
-                self._pending_requests = []
+            self._check_frame_modification()
 
             pending_events = []
             with self._lock:
@@ -90,12 +101,12 @@ class LldbBridge(BridgeInterface):
                 callback = requests_to_process.pop(0)
                 callback()
 
-            time.sleep(0.1)
-
     def queue_request(self, callable_request):
         # type: (Callable[[None],None]) -> None
-        with self._lock:
-            self._pending_requests.append(callable_request)
+        self._requests.put(callable_request)
+
+    def watch_descriptors(self, descriptors, callable_request):
+        self._requests.watch(descriptors, callable_request)
 
     def _get_process(self, debugger):
         # type: (lldb.SBDebugger) -> lldb.SBProcess
@@ -115,8 +126,8 @@ class LldbBridge(BridgeInterface):
             return None
         return thread.GetSelectedFrame()
 
-    def get_buffer_metadata(self, variable):
-        # type: (str) -> dict
+    def get_buffer_metadata(self, variable, region=None, read_contents=True):
+        # type: (str, tuple, bool) -> dict
         process = self._get_process(self.get_lldb_backend())
         thread = self._get_thread(process)
         frame = self._get_frame(thread)
@@ -125,6 +136,7 @@ class LldbBridge(BridgeInterface):
             # Could not fetch frame from debugger state
             return None
 
+        self._clear_stale_caches(process)
         picked_obj = frame.EvaluateExpression(variable)  # type: lldb.SBValue
 
         buffer_metadata = self._type_bridge.get_buffer_metadata(
@@ -134,69 +146,236 @@ class LldbBridge(BridgeInterface):
             # Invalid symbol for current frame
             return None
 
-        bufsize = sysinfo.get_buffer_size(
-            buffer_metadata['height'],
-            buffer_metadata['channels'],
-            buffer_metadata['type'],
-            buffer_metadata['row_stride']
-        )
+        bufsize = regions.get_read_size(buffer_metadata)
 
         # Check if buffer is initialized
         if buffer_metadata['pointer'] == 0x0:
             raise RuntimeError('Invalid null buffer pointer')
         if bufsize == 0:
             raise ValueError('Invalid buffer of zero bytes')
-        elif bufsize >= sysinfo.get_available_memory() / 10:
-            raise MemoryError('Invalid buffer size larger than available memory')
+
+        # Buffers too large to be read whole are sent as an overview, and the
+        # window requests the regions it displays
+        memory_budget = sysinfo.get_available_memory() / 10
+        if region is None and bufsize >= memory_budget:
+            region = regions.get_overview_region(buffer_metadata, memory_budget)
 
         buffer_metadata['variable_name'] = variable
-        buffer_metadata['pointer'] = memoryview(process.ReadMemory(
-            buffer_metadata['pointer'], bufsize, lldb.SBError()))
+        buffer_metadata['address'] = int(buffer_metadata['pointer'])
+        if region is not None:
+            buffer_metadata['region'] = tuple(region)
+
+        if read_contents:
+            self.read_buffer_contents(buffer_metadata)
 
         return buffer_metadata
 
+    def read_buffer_contents(self, buffer_metadata):
+        process = self._get_process(self.get_lldb_backend())
+
+        def read_memory(address, size):
+            return process.ReadMemory(address, size, lldb.SBError())
+
+        address = buffer_metadata['address']
+        if 'region' in buffer_metadata:
+            buffer_metadata['pointer'] = regions.read_region(
+                read_memory, address, buffer_metadata,
+                buffer_metadata['region'])
+        else:
+            buffer_metadata['pointer'] = regions.read_buffer(
+                read_memory, address, buffer_metadata)
+
+    def get_inferior_pid(self):
+        process = self._get_process(self.get_lldb_backend())
+        if not process.IsValid() or \
+                process.GetPluginName() in CORE_FILE_PLUGINS:
+            return None
+
+        # Processes debugged through a remote platform run elsewhere
+        if process.GetTarget().GetPlatform().GetName() != 'host':
+            return None
+
+        return process.GetProcessID()
+
+    @staticmethod
+    def _find_field(struct_type, name):
+        # type: (lldb.SBType, str) -> tuple
+        """
+        Find the offset and type of the member 'name' of 'struct_type',
+        looking into base classes and anonymous unions as well. Returns None
+        if it is not found or is a bit field.
+        """
+        for field_idx in range(struct_type.GetNumberOfFields()):
+            field = struct_type.GetFieldAtIndex(field_idx)
+            if field.IsBitfield():
+                continue
+
+            if field.GetName() == name:
+                return field.GetOffsetInBytes(), field.GetType()
+
+            if not field.GetName():
+                found = LldbBridge._find_field(
+                    field.GetType().GetCanonicalType(), name)
+                if found is not None:
+                    return field.GetOffsetInBytes() + found[0], found[1]
+
+        for base_idx in range(struct_type.GetNumberOfDirectBaseClasses()):
+            base = struct_type.GetDirectBaseClassAtIndex(base_idx)
+            found = LldbBridge._find_field(
+                base.GetType().GetCanonicalType(), name)
+            if found is not None:
+                return base.GetOffsetInBytes() + found[0], found[1]
+
+        return None
+
+    def get_header_layout(self, picked_obj, header_fields):
+        struct_type = picked_obj.sbvalue.GetType().GetCanonicalType()
+        if struct_type.IsPointerType():
+            struct_type = struct_type.GetPointeeType().GetCanonicalType()
+        elif struct_type.IsReferenceType():
+            struct_type = struct_type.GetDereferencedType().GetCanonicalType()
+
+        layout = {}
+        for key, path in header_fields.items():
+            offset = 0
+            field_type = struct_type
+            for step in path:
+                field_type = field_type.GetCanonicalType()
+                if isinstance(step, int):
+                    if not field_type.IsArrayType():
+                        return None
+                    field_type = field_type.GetArrayElementType()
+                    offset += step * field_type.GetByteSize()
+                else:
+                    found = LldbBridge._find_field(field_type, step)
+                    if found is None:
+                        return None
+                    offset += found[0]
+                    field_type = found[1]
+
+            field_type = field_type.GetCanonicalType()
+            is_signed = not field_type.IsPointerType() and \
+                (field_type.GetTypeFlags() & lldb.eTypeIsSigned) != 0
+            layout[key] = (offset, field_type.GetByteSize(), is_signed)
+
+        process = self._get_process(self.get_lldb_backend())
+        is_little_endian = process.GetByteOrder() == lldb.eByteOrderLittle
+        return layout, '<' if is_little_endian else '>'
+
+    def get_object_address(self, picked_obj):
+        value = picked_obj.sbvalue
+        value_type = value.GetType().GetCanonicalType()
+        if value_type.IsPointerType():
+            return value.GetValueAsUnsigned()
+        if value_type.IsReferenceType():
+            value = value.Dereference()
+
+        address = value.GetLoadAddress()
+        return address if address != lldb.LLDB_INVALID_ADDRESS else None
+
+    def read_memory(self, address, size):
+        process = self._get_process(self.get_lldb_backend())
+        error = lldb.SBError()
+        contents = process.ReadMemory(address, size, error)
+        if error.Fail():
+            raise RuntimeError(f'Could not read memory at {address:#x}: '
+                               f'{error.GetCString()}')
+
+        return contents
+
     def register_event_handlers(self, event_handler):
         self._event_handler = event_handler
 
     def get_casted_pointer(self, typename, lldb_object):
         return lldb_object.get_casted_pointer()
 
-    def _get_observable_children_members(self, symbol, member_name_chain,
-                                         output_set, visited_typenames=None):
-        # type: (lldb.SBValue, list[str], set, set) -> None
-        if visited_typenames is None:
-            visited_typenames = set()
-        if symbol.GetTypeName() in visited_typenames:
+    def _get_observable_members(self, symbol, visiting_typenames):
+        # type: (lldb.SBValue, set) -> tuple[tuple, bool]
+        """
+        Get the chains of member names that lead from 'symbol' to observable
+        members, and whether they only depend on the type of 'symbol'. That is
+        not the case when synthetic children are involved, such as the
+        elements of containers.
+        """
+        type_name = symbol.GetTypeName()
+        if type_name in self._observable_members:
+            return self._observable_members[type_name], True
+
+        if type_name in visiting_typenames:
             # Prevent endless recursion in cyclic data types
-            return
+            return (), True
+
+        visiting_typenames.add(type_name)
 
+        members = []
+        is_type_dependent = not symbol.IsSynthetic()
         for member_idx in range(symbol.GetNumChildren()):
             symbol_member = symbol.GetChildAtIndex(
                 member_idx)  # type: lldb.SBValue
-
-            member_name_chain_current = member_name_chain.copy()
-            member_name_chain_current.append(str(symbol_member.name))
+            member_name = str(symbol_member.name)
 
             symbol_wrapper = SymbolWrapper(symbol_member)
             if self._type_bridge.is_symbol_observable(symbol_wrapper,
                                                       symbol_member.name):
-                member_name_current = '.'.join(member_name_chain_current)
-                output_set.add(member_name_current)
+                members.append((member_name,))
             else:
-                if symbol_member.name != symbol_member.GetTypeName():
-                    visited_typenames.add(symbol_member.GetTypeName())
-                self._get_observable_children_members(symbol_member,
-                                                      member_name_chain_current,
-                                                      output_set,
-                                                      visited_typenames)
+                child_members, is_child_type_dependent = \
+                    self._get_observable_members(symbol_member,
+                                                 visiting_typenames)
+                members.extend((member_name,) + chain
+                               for chain in child_members)
+                is_type_dependent = is_type_dependent and \
+                    is_child_type_dependent
+
+        visiting_typenames.discard(type_name)
+
+        members = tuple(members)
+        if is_type_dependent:
+            self._observable_members[type_name] = members
+
+        return members, is_type_dependent
+
+    def _get_scope(self, frame):
+        # type: (lldb.SBFrame) -> tuple
+        """
+        Identify the function and the innermost block where 'frame' stopped
+        """
+        target = frame.GetThread().GetProcess().GetTarget()
+        block = frame.GetBlock()
+        if not block.IsValid():
+            return None
+
+        return (frame.GetFunction().GetStartAddress().GetLoadAddress(target),
+                block.GetRangeStartAddress(0).GetLoadAddress(target))
+
+    def _clear_stale_caches(self, process):
+        """
+        Cached symbols and types only hold for the modules of the process they
+        were listed in, so they are dropped once modules are (un)loaded
+        """
+        modules_id = (process.GetProcessID(),
+                      process.GetTarget().GetNumModules())
+        if modules_id != self._symbols_modules_id:
+            self._observable_members.clear()
+            self._scope_symbols.clear()
+            self._type_bridge.clear_type_inspector_cache()
+            self._type_bridge.clear_header_plans()
+            self._symbols_modules_id = modules_id
 
     def get_available_symbols(self):
-        frame = self._get_frame(
-            self._get_thread(self._get_process(self.get_lldb_backend())))
+        process = self._get_process(self.get_lldb_backend())
+        frame = self._get_frame(self._get_thread(process))
         if not frame:
             return set()
 
+        self._clear_stale_caches(process)
+
+        scope = self._get_scope(frame)
+        if scope in self._scope_symbols:
+            return set(self._scope_symbols[scope])
+
         available_symbols = set()
+        is_type_dependent = True
 
         for symbol in frame.GetVariables(True, True, True, True):
             symbol_wrapper = SymbolWrapper(symbol)
@@ -204,9 +383,16 @@ class LldbBridge(BridgeInterface):
                                                       symbol.name):
                 available_symbols.add(symbol.name)
             # Check for members of current field, if it is a class
-            member_name_chain = [symbol.name] if symbol.name != 'this' else []
-            self._get_observable_children_members(symbol, member_name_chain,
-                                                  available_symbols)
+            member_name_chain = (symbol.name,) if symbol.name != 'this' else ()
+            members, is_symbol_type_dependent = \
+                self._get_observable_members(symbol, set())
+            available_symbols.update('.'.join(member_name_chain + chain)
+                                     for chain in members)
+            is_type_dependent = is_type_dependent and is_symbol_type_dependent
+
+        # Scopes whose symbols depend on values are listed on every stop
+        if scope is not None and is_type_dependent:
+            self._scope_symbols[scope] = frozenset(available_symbols)
 
         return available_symbols
 
@@ -220,6 +406,11 @@ class SymbolWrapper(DebuggerSymbolReference):
         self._symbol = symbol  # type: lldb.SBValue
         self.type = symbol.GetTypeName()  # type: str
 
+    @property
+    def sbvalue(self):
+        # type: () -> lldb.SBValue
+        return self._symbol
+
     def __str__(self):
         return str(self._symbol.GetValue())
 
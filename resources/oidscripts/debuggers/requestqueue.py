@@ -0,0 +1,113 @@
+# -*- coding: utf-8 -*-
+
+"""
+Queue of requests to be executed by the debugger, which the event loop thread
+of a bridge blocks on instead of polling
+"""
+
+import select
+import socket
+import threading
+
+
+class RequestQueue(object):
+    """
+    Requests queued by any thread, along with file descriptors whose
+    readiness queues a request as well. The event loop thread waits until
+    either happens.
+    """
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._requests = []
+
+        # Watched descriptors, mapped to the request queued when they become
+        # readable. Descriptors are not waited upon while their request is
+        # pending, since they remain readable until it runs.
+        self._watches = {}
+        self._pending_watches = set()
+
+        # Wakes the event loop thread up when requests are queued by others
+        self._wakeup_reader, self._wakeup_writer = socket.socketpair()
+        self._wakeup_reader.setblocking(False)
+        self._wakeup_writer.setblocking(False)
+
+    def put(self, callable_request):
+        """
+        Queue 'callable_request' and wake the event loop thread up
+        """
+        with self._lock:
+            self._requests.append(callable_request)
+        self._wake_up()
+
+    def watch(self, descriptors, callable_request):
+        """
+        Queue 'callable_request' whenever any of the file 'descriptors' becomes
+        readable. Once it runs, the descriptors are watched again if it
+        returned True, and forgotten otherwise.
+        """
+        descriptors = tuple(descriptors)
+
+        def watched_request():
+            keep_watching = False
+            try:
+                keep_watching = callable_request()
+            finally:
+                with self._lock:
+                    if keep_watching:
+                        self._pending_watches.difference_update(descriptors)
+                    else:
+                        for descriptor in descriptors:
+                            self._pending_watches.discard(descriptor)
+                            self._watches.pop(descriptor, None)
+                self._wake_up()
+
+        with self._lock:
+            for descriptor in descriptors:
+                self._watches[descriptor] = (descriptors, watched_request)
+        self._wake_up()
+
+    def wait(self, timeout=None):
+        """
+        Block until requests are queued or watched descriptors are readable,
+        or until 'timeout' seconds have elapsed, and take the queued requests
+        """
+        with self._lock:
+            watched = [descriptor for descriptor in self._watches
+                       if descriptor not in self._pending_watches]
+
+        try:
+            readable, _, _ = select.select([self._wakeup_reader] + watched,
+                                           [], [], timeout)
+        except (OSError, ValueError):
+            # A descriptor was closed while being waited upon. Its request
+            # finds out about it once it runs.
+            readable = watched
+
+        if self._wakeup_reader in readable:
+            try:
+                while self._wakeup_reader.recv(4096):
+                    pass
+            except (BlockingIOError, InterruptedError):
+                pass
+
+        with self._lock:
+            for descriptor in readable:
+                if descriptor not in self._watches or \
+                        descriptor in self._pending_watches:
+                    continue
+
+                descriptors, watched_request = self._watches[descriptor]
+                self._pending_watches.update(descriptors)
+                self._requests.append(watched_request)
+
+            requests = self._requests
+            self._requests = []
+
+        return requests
+
+    def _wake_up(self):
+        try:
+            self._wakeup_writer.send(b'\0')
+        except (BlockingIOError, InterruptedError):
+            # The event loop thread is already due to wake up
+            pass
@@ -17,22 +17,14 @@ class OpenImageDebuggerEvents(BridgeEventHandlerInterface):
         self._window = window
         self._debugger = debugger
 
-    def _set_symbol_complete_list(self):
-        """
-        Retrieve the list of available symbols and provide it to the OID window
-        for autocompleting.
-        """
-        observable_symbols = list(self._debugger.get_available_symbols())
-        if self._window.is_ready():
-            self._window.set_available_symbols(observable_symbols)
-
     def exit_handler(self):
         self._window.terminate()
 
     def stop_handler(self):
         """
-        The debugger has stopped (e.g. a breakpoint was hit). We must list all
-        available buffers and pass it to the Open Image Debugger window.
+        The debugger has stopped (e.g. a breakpoint was hit). We must update
+        the buffers being visualized. Available symbols are only listed once
+        the Open Image Debugger window asks for them.
         """
         # Block until the window is up and running
         if not self._window.is_ready():
@@ -40,13 +32,15 @@ class OpenImageDebuggerEvents(BridgeEventHandlerInterface):
             while not self._window.is_ready():
                 time.sleep(0.1)
 
-        # Update buffers being visualized
-        observed_buffers = self._window.get_observed_buffers()
-        for buffer_name in observed_buffers:
-            self._window.plot_variable(buffer_name)
+        # The window may ask for symbols as soon as it learns about the stop
+        self._window.invalidate_available_symbols()
 
-        # Set list of available symbols
-        self._set_symbol_complete_list()
+        # Update buffers being visualized. They are all read at once, so that
+        # unchanged ones are recognized on the next stop. The one selected in
+        # the window comes first and is sent on its own, ahead of the batch
+        # with the rest
+        observed_buffers = self._window.get_observed_buffers()
+        self._window.plot_variables(observed_buffers, is_first_sent_apart=True)
 
     def plot_handler(self, variable_name):
         """
@@ -0,0 +1,65 @@
+# -*- coding: utf-8 -*-
+
+"""
+Compiled plans that decode the header struct of a buffer type (e.g. the
+fields of a cv::Mat) from a single read of the debugged process memory,
+instead of looking each field up through the debugger
+"""
+
+import struct
+
+# struct format codes of signed integers of each size, in bytes. Unsigned ones
+# are the same codes in upper case.
+INTEGER_FORMATS = {1: 'b', 2: 'h', 4: 'i', 8: 'q'}
+
+
+class HeaderPlan(object):
+    """
+    Decodes the fields of a header struct, once read from memory
+    """
+    def __init__(self, keys, header_struct):
+        self._keys = keys
+        self._struct = header_struct
+
+    @property
+    def size(self):
+        """
+        Number of bytes to be read, starting at the address of the struct
+        """
+        return self._struct.size
+
+    def decode(self, data):
+        """
+        Decode the header fields from the bytes-like object 'data' into a dict
+        """
+        return dict(zip(self._keys, self._struct.unpack_from(data)))
+
+
+def compile_plan(layout, byte_order):
+    """
+    Compile the plan of a header given the dict 'layout', which maps each field
+    key to a tuple (offset, size, is_signed), in bytes. 'byte_order' is '<' or
+    '>' for little and big endian targets, respectively.
+
+    Returns None if the layout cannot be decoded in one go, e.g. if fields
+    overlap or are not integers.
+    """
+    header_format = byte_order
+    position = 0
+    keys = []
+
+    for key, (offset, size, is_signed) in sorted(layout.items(),
+                                                 key=lambda item: item[1][0]):
+        if size not in INTEGER_FORMATS or offset < position:
+            return None
+
+        if offset > position:
+            header_format += f'{offset - position}x'
+
+        format_code = INTEGER_FORMATS[size]
+        header_format += format_code if is_signed else format_code.upper()
+
+        position = offset + size
+        keys.append(key)
+
+    return HeaderPlan(keys, struct.Struct(header_format))
@@ -47,6 +47,13 @@ class TypeInspectorInterface(object):
     extract information required for plotting buffers.
     """
 
+    # Integer fields of the inspected struct that describe its buffer, as a
+    # dict mapping a key to the path of the field: member names and array
+    # indices (e.g. ('step', 'buf', 0)). If given, the type bridge reads them
+    # all at once from memory and calls get_header_metadata instead of
+    # get_buffer_metadata. Pointers are read as their address.
+    header_fields = None
+
     @abc.abstractmethod
     def get_buffer_metadata(self,
                             obj_name,  # type: str
@@ -76,6 +83,20 @@ class TypeInspectorInterface(object):
         """
         pass
 
+    def get_header_metadata(self,
+                            obj_name,  # type: str
+                            picked_obj,  # type: DebuggerSymbolReference
+                            header  # type: dict
+                            ):
+        # type: (...) -> dict
+        """
+        Same as get_buffer_metadata, given the values of header_fields as the
+        dict 'header' instead of the debugger interface. The pointer field
+        must be the buffer address, as an int. Only required if header_fields
+        is defined.
+        """
+        raise NotImplementedError("Method is not implemented")
+
     @abc.abstractmethod
     def is_symbol_observable(self, symbol_obj, symbol_name):
         # type: (DebuggerSymbolReference, str) -> bool
@@ -84,5 +105,8 @@ class TypeInspectorInterface(object):
         symbol_name, this method must return True if the symbol corresponds
         to an observable variable (i.e. if its type corresponds to the type
         of the buffers that you want to plot).
+
+        The answer must only depend on the type of the symbol: it is computed
+        once per type name, and reused for every symbol of that type.
         """
         pass
@@ -24,15 +24,34 @@ class Mat(interface.TypeInspectorInterface):
     """
     Implementation for inspecting OpenCV Mat classes
     """
+    header_fields = {
+        'data': ('data',),
+        'cols': ('cols',),
+        'rows': ('rows',),
+        'flags': ('flags',),
+        'step': ('step', 'buf', 0),
+    }
+
     def get_buffer_metadata(self, obj_name, picked_obj, debugger_bridge):
-        buffer = debugger_bridge.get_casted_pointer('char', picked_obj['data'])
+        header = {
+            'data': debugger_bridge.get_casted_pointer('char',
+                                                       picked_obj['data']),
+            'cols': int(picked_obj['cols']),
+            'rows': int(picked_obj['rows']),
+            'flags': int(picked_obj['flags']),
+            'step': int(picked_obj['step']['buf'][0]),
+        }
+        return self.get_header_metadata(obj_name, picked_obj, header)
+
+    def get_header_metadata(self, obj_name, picked_obj, header):
+        buffer = header['data']
 
-        width = int(picked_obj['cols'])
-        height = int(picked_obj['rows'])
-        flags = int(picked_obj['flags'])
+        width = header['cols']
+        height = header['rows']
+        flags = header['flags']
 
         channels = ((((flags) & CV_MAT_CN_MASK) >> CV_CN_SHIFT) + 1)
-        row_stride = int(int(picked_obj['step']['buf'][0])/channels)
+        row_stride = int(header['step']/channels)
 
         if channels >= 3:
             pixel_layout = 'bgra'
@@ -79,20 +98,39 @@ class CvMat(interface.TypeInspectorInterface):
     """
     Implementation for inspecting OpenCV CvMat structs
     """
+    # The data union only holds pointers, which are read as an address
+    header_fields = {
+        'data': ('data',),
+        'cols': ('cols',),
+        'rows': ('rows',),
+        'type': ('type',),
+        'step': ('step',),
+    }
+
     def get_buffer_metadata(self, obj_name, picked_obj, debugger_bridge):
         data = picked_obj['data']
         if data.type == 'CvMat::(unnamed union)':
             data = data[0]
-        buffer = debugger_bridge.get_casted_pointer('char', data)
+        header = {
+            'data': debugger_bridge.get_casted_pointer('char', data),
+            'cols': int(picked_obj['cols']),
+            'rows': int(picked_obj['rows']),
+            'type': int(picked_obj['type']),
+            'step': int(picked_obj['step']),
+        }
+        return self.get_header_metadata(obj_name, picked_obj, header)
+
+    def get_header_metadata(self, obj_name, picked_obj, header):
+        buffer = header['data']
         if buffer == 0x0:
             raise RuntimeError('Received null buffer!')
 
-        width = int(picked_obj['cols'])
-        height = int(picked_obj['rows'])
-        flags = int(picked_obj['type'])
+        width = header['cols']
+        height = header['rows']
+        flags = header['type']
 
         channels = ((((flags) & CV_MAT_CN_MASK) >> CV_CN_SHIFT) + 1)
-        row_stride = int(int(picked_obj['step'])/channels)
+        row_stride = int(header['step']/channels)
 
         if channels >= 3:
             pixel_layout = 'bgra'
@@ -140,16 +178,37 @@ class IplImage(interface.TypeInspectorInterface):
              32: symbols.OID_TYPES_FLOAT32,
              64: symbols.OID_TYPES_FLOAT64}
 
+    header_fields = {
+        'imageData': ('imageData',),
+        'width': ('width',),
+        'height': ('height',),
+        'nChannels': ('nChannels',),
+        'depth': ('depth',),
+        'widthStep': ('widthStep',),
+    }
+
     def get_buffer_metadata(self, obj_name, picked_obj, debugger_bridge):
-        buffer = debugger_bridge.get_casted_pointer('char', picked_obj['imageData'])
+        header = {
+            'imageData': debugger_bridge.get_casted_pointer(
+                'char', picked_obj['imageData']),
+            'width': int(picked_obj['width']),
+            'height': int(picked_obj['height']),
+            'nChannels': int(picked_obj['nChannels']),
+            'depth': int(picked_obj['depth']),
+            'widthStep': int(picked_obj['widthStep']),
+        }
+        return self.get_header_metadata(obj_name, picked_obj, header)
+
+    def get_header_metadata(self, obj_name, picked_obj, header):
+        buffer = header['imageData']
         if buffer == 0x0:
             raise RuntimeError('Received null buffer!')
 
-        width = int(picked_obj['width'])
-        height = int(picked_obj['height'])
-        channels = int(picked_obj['nChannels'])
-        depth = int(picked_obj['depth'])
-        row_stride = int(int(picked_obj['widthStep']) / depth * 8)
+        width = header['width']
+        height = header['height']
+        channels = header['nChannels']
+        depth = header['depth']
+        row_stride = int(header['widthStep'] / depth * 8)
 
         if channels >= 3:
             pixel_layout = 'bgra'
@@ -9,7 +9,7 @@ import ctypes.util
 import os
 import platform
 import sys
-import time
+import threading
 
 from oidscripts.logger import log
 
@@ -19,6 +19,67 @@ FETCH_BUFFER_CBK_TYPE = ctypes.CFUNCTYPE(ctypes.c_int,
 
 PLATFORM_NAME = platform.system().lower()
 
+# Buffers with at least this many pixels are preceded by a preview with
+# 1/(factor*factor) of their pixels, so that something is displayed while the
+# full resolution contents are transferred
+PREVIEW_DOWNSAMPLING_THRESHOLDS = [
+    (16 * 1024 * 1024, 4),
+    (4 * 1024 * 1024, 2),
+]
+
+def get_plot_metadata(lib, native_handler, bridge, variable, region=None):
+    """
+    Get the metadata of 'variable' to be given to oid_plot_buffer. If the
+    debugged process runs on this machine, its contents are left for the
+    native library to read directly, which spares a copy through the debugger.
+    """
+    buffer_metadata = bridge.get_buffer_metadata(variable, region,
+                                                 read_contents=False)
+    if buffer_metadata is None:
+        return None
+
+    pid = bridge.get_inferior_pid()
+    if pid is not None and lib.oid_can_read_inferior_memory(
+            native_handler, pid, buffer_metadata['address']):
+        buffer_metadata['pid'] = pid
+        del buffer_metadata['pointer']
+    else:
+        bridge.read_buffer_contents(buffer_metadata)
+
+    return buffer_metadata
+
+
+class PendingPlots(object):
+    """
+    Keeps the latest plot queued for each symbol, so that plots queued before
+    it (e.g. while the user steps faster than buffers can be sent) are dropped
+    instead of replaying every intermediate state of the buffer
+    """
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._latest = {}
+
+    def register(self, keys, plotter):
+        """
+        Make 'plotter' the latest plot queued for each of the 'keys'
+        """
+        with self._lock:
+            for key in keys:
+                self._latest[key] = plotter
+
+    def take(self, keys, plotter):
+        """
+        Returns the subset of 'keys' for which 'plotter' is still the latest
+        queued plot, which are then no longer pending
+        """
+        with self._lock:
+            latest_keys = [key for key in keys
+                           if self._latest.get(key) is plotter]
+            for key in latest_keys:
+                del self._latest[key]
+            return latest_keys
+
+
 class OpenImageDebuggerWindow(object):
     """
     Python interface for the OpenImageDebugger window, which is implemented as a
@@ -65,6 +126,16 @@ class OpenImageDebuggerWindow(object):
         ]
         self._lib.oid_set_available_symbols.restype = None
 
+        self._lib.oid_update_available_symbols.argtypes = [
+            ctypes.c_void_p,
+            ctypes.py_object,
+            ctypes.py_object
+        ]
+        self._lib.oid_update_available_symbols.restype = None
+
+        self._lib.oid_get_event_descriptors.argtypes = [ctypes.c_void_p]
+        self._lib.oid_get_event_descriptors.restype = ctypes.py_object
+
         self._lib.oid_run_event_loop.argtypes = [ctypes.c_void_p]
         self._lib.oid_run_event_loop.restype = None
 
@@ -74,16 +145,36 @@ class OpenImageDebuggerWindow(object):
         ]
         self._lib.oid_plot_buffer.restype = None
 
+        self._lib.oid_plot_buffers.argtypes = [
+            ctypes.c_void_p,
+            ctypes.py_object,
+            ctypes.c_int
+        ]
+        self._lib.oid_plot_buffers.restype = None
+
+        self._lib.oid_can_read_inferior_memory.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int64,
+            ctypes.c_uint64
+        ]
+        self._lib.oid_can_read_inferior_memory.restype = ctypes.c_int
+
+        self._lib.oid_get_pending_plots.argtypes = [ctypes.c_void_p]
+        self._lib.oid_get_pending_plots.restype = ctypes.c_int
+
         # UI handler
         self._native_handler = None
         self._event_loop_wait_time = 1.0/30.0
-        self._previous_evloop_time = OpenImageDebuggerWindow.__get_time_ms()
         self._plot_variable_c_callback = FETCH_BUFFER_CBK_TYPE(self.plot_variable)
 
+        # Symbols last sent to the window, and whether the debugger stopped
+        # since they were listed
+        self._sent_symbols = set()
+        self._are_symbols_stale = True
+
+        # Latest plot queued for each symbol
+        self._pending_plots = PendingPlots()
 
-    @staticmethod
-    def __get_time_ms():
-        return int(time.time() * 1000.0)
 
     @staticmethod
     def __get_library_name():
@@ -119,7 +210,8 @@ class OpenImageDebuggerWindow(object):
             plot_callable = DeferredVariablePlotter(variable,
                                                     self._lib,
                                                     self._bridge,
-                                                    self._native_handler)
+                                                    self._native_handler,
+                                                    self._pending_plots)
             self._bridge.queue_request(plot_callable)
             return 1
         except Exception as err:
@@ -128,6 +220,49 @@ class OpenImageDebuggerWindow(object):
 
         return 0
 
+    def plot_variables(self, requested_symbols, is_first_sent_apart=False):
+        """
+        Plot all variables whose names are in the list 'requested_symbols',
+        which the window displays together. All of them are read at once; if
+        'is_first_sent_apart' is True, the first one is sent on its own, ahead
+        of the others.
+        """
+        if self._bridge is None:
+            log.info("Could not plot symbols: Not a debugging session")
+            return
+
+        variables = [symbol.decode('utf-8')
+                     if not isinstance(symbol, str) else symbol
+                     for symbol in requested_symbols]
+        if not variables:
+            return
+
+        plot_callable = DeferredVariableListPlotter(variables,
+                                                    self._lib,
+                                                    self._bridge,
+                                                    self._native_handler,
+                                                    self._pending_plots,
+                                                    is_first_sent_apart)
+        self._bridge.queue_request(plot_callable)
+
+    def plot_variable_region(self, variable, x, y, width, height,
+                             downsampling):
+        """
+        Plot a region of a variable that is too large to be plotted whole, as
+        requested by the window when its view changes.
+        """
+        if self._bridge is None:
+            return
+
+        region = (x, y, width, height, downsampling)
+        plot_callable = DeferredVariablePlotter(variable,
+                                                self._lib,
+                                                self._bridge,
+                                                self._native_handler,
+                                                self._pending_plots,
+                                                region)
+        self._bridge.queue_request(plot_callable)
+
     def is_ready(self):
         """
         Returns True if the OpenImageDebugger window has been loaded; False otherwise.
@@ -146,31 +281,79 @@ class OpenImageDebuggerWindow(object):
     def set_available_symbols(self, observable_symbols):
         """
         Set the autocomplete list of symbols with the list of string
-        'observable_symbols'
+        'observable_symbols'. Only the symbols added or removed since the
+        previous list are sent to the window, which keeps the list sorted.
+        """
+        observable_symbols = set(observable_symbols)
+
+        added_symbols = list(observable_symbols - self._sent_symbols)
+        removed_symbols = list(self._sent_symbols - observable_symbols)
+        self._sent_symbols = observable_symbols
+
+        if added_symbols or removed_symbols:
+            self._lib.oid_update_available_symbols(
+                self._native_handler,
+                added_symbols,
+                removed_symbols)
+
+    def invalidate_available_symbols(self):
+        """
+        Signal that the debugger stopped, so that symbols are listed again the
+        next time the window asks for them
+        """
+        self._are_symbols_stale = True
+
+    def update_available_symbols(self):
+        """
+        Called by the window when it needs the symbols available in the current
+        context, e.g. when the symbol search input is focused. Symbols are only
+        listed once per stop of the debugger.
         """
+        if self._bridge is None or not self._are_symbols_stale:
+            return
 
-        # Perform two-level sorting:
-        #    1. By amount of nodes.
-        #    2. By variable name.
-        sorted_observable_symbols = sorted(observable_symbols, key=lambda symbol: (symbol.count('.'), symbol))
+        try:
+            observable_symbols = self._bridge.get_available_symbols()
+        except Exception as err:
+            log.error('Could not list available symbols')
+            log.error(err)
+            return
 
-        self._lib.oid_set_available_symbols(
-            self._native_handler,
-            sorted_observable_symbols)
+        self._are_symbols_stale = False
+        self.set_available_symbols(observable_symbols)
 
     def run_event_loop(self):
         """
         Run the debugger-side event loop, which consists of checking for new
-        user requests coming from the UI
+        user requests coming from the UI. Returns True while the window is
+        open, so that its event descriptors keep being watched.
         """
-        current_time = OpenImageDebuggerWindow.__get_time_ms()
-        dt = current_time - self._previous_evloop_time
-        if dt > self._event_loop_wait_time:
-            self._lib.oid_run_event_loop(self._native_handler)
-            self._previous_evloop_time = current_time
+        if not self.is_ready():
+            return False
+
+        self._lib.oid_run_event_loop(self._native_handler)
+        return True
+
+    def _poll_event_loop(self):
+        """
+        Run the event loop periodically, on platforms where the debugger
+        cannot wait for requests from the UI
+        """
+        self._lib.oid_run_event_loop(self._native_handler)
 
         # Schedule next run of the event loop
-        self._bridge.queue_request(self.run_event_loop)
+        timer = threading.Timer(self._event_loop_wait_time,
+                                self._bridge.queue_request,
+                                args=(self._poll_event_loop,))
+        timer.daemon = True
+        timer.start()
+
+    def get_pending_plots(self):
+        """
+        Get the number of plotted buffers whose contents are still being sent
+        to the OID window
+        """
+        return self._lib.oid_get_pending_plots(self._native_handler)
 
     def get_observed_buffers(self):
         """
@@ -182,34 +365,67 @@ class OpenImageDebuggerWindow(object):
         # Initialize OID lib
         self._native_handler = self._lib.oid_initialize(
             self._plot_variable_c_callback,
-            {'oid_path': self._script_path})
+            {'oid_path': self._script_path,
+             'region_callback': self.plot_variable_region,
+             'plot_buffers_callback': self.plot_variables,
+             'symbols_callback': self.update_available_symbols})
 
         # Launch UI
         self._lib.oid_exec(self._native_handler)
 
-        # Schedule event loop
-        self._bridge.queue_request(self.run_event_loop)
+        # Run the event loop whenever the UI sends requests, or poll it if the
+        # platform cannot wait for them
+        descriptors = self._lib.oid_get_event_descriptors(
+            self._native_handler)
+        if descriptors:
+            self._bridge.watch_descriptors(descriptors, self.run_event_loop)
+        else:
+            self._bridge.queue_request(self._poll_event_loop)
 
 
 class DeferredVariablePlotter(object):
     """
     Instances of this class are callable objects whose __call__ method triggers
     a buffer plot command. Useful for deferring the plot command to a safe
-    thread.
+    thread. The command is dropped if a newer plot of the same variable was
+    queued in the meantime.
     """
-    def __init__(self, variable, lib, bridge, native_handler):
+    def __init__(self, variable, lib, bridge, native_handler, pending_plots,
+                 region=None):
         self._variable = variable
         self._lib = lib
         self._bridge = bridge
         self._native_handler = native_handler
+        self._region = region
+
+        # Regions only supersede other regions of the same variable
+        self._key = (variable, 'region') if region is not None else variable
+        self._pending_plots = pending_plots
+        self._pending_plots.register([self._key], self)
 
     def __call__(self):
+        if not self._pending_plots.take([self._key], self):
+            return
+
         try:
-            buffer_metadata = self._bridge.get_buffer_metadata(self._variable)
+            buffer_metadata = get_plot_metadata(self._lib,
+                                                self._native_handler,
+                                                self._bridge,
+                                                self._variable,
+                                                self._region)
 
             if buffer_metadata is None:
                 return
 
+            # Regions are already sampled to the resolution being displayed
+            if 'region' not in buffer_metadata:
+                pixel_count = \
+                    buffer_metadata['width'] * buffer_metadata['height']
+                for threshold, downsampling in PREVIEW_DOWNSAMPLING_THRESHOLDS:
+                    if pixel_count >= threshold:
+                        buffer_metadata['preview_downsampling'] = downsampling
+                        break
+
             self._lib.oid_plot_buffer(
                 self._native_handler,
                 buffer_metadata)
@@ -219,3 +435,57 @@ class DeferredVariablePlotter(object):
             log.error("Could not plot variable")
             log.error(err)
             traceback.print_exc()
+
+
+class DeferredVariableListPlotter(object):
+    """
+    Callable object that plots several variables with a single batch, so that
+    the window displays them in one go. Variables for which a newer plot was
+    queued in the meantime are left out of the batch. The first variable may
+    be sent in a batch of its own, ahead of the others.
+    """
+    def __init__(self, variables, lib, bridge, native_handler, pending_plots,
+                 is_first_sent_apart=False):
+        self._variables = variables
+        self._lib = lib
+        self._bridge = bridge
+        self._native_handler = native_handler
+        self._pending_plots = pending_plots
+        self._is_first_sent_apart = is_first_sent_apart
+        self._pending_plots.register(variables, self)
+
+    def __call__(self):
+        buffer_metadata_list = []
+        is_first_sent_apart = False
+        for variable in self._pending_plots.take(self._variables, self):
+            try:
+                buffer_metadata = get_plot_metadata(self._lib,
+                                                    self._native_handler,
+                                                    self._bridge,
+                                                    variable)
+            except Exception as err:
+                log.error(f"Could not plot variable {variable}")
+                log.error(err)
+                continue
+
+            # Symbols that are not valid in the current frame are skipped
+            if buffer_metadata is not None:
+                if not buffer_metadata_list:
+                    is_first_sent_apart = self._is_first_sent_apart and \
+                        variable == self._variables[0]
+                buffer_metadata_list.append(buffer_metadata)
+
+        if not buffer_metadata_list:
+            return
+
+        try:
+            self._lib.oid_plot_buffers(
+                self._native_handler,
+                buffer_metadata_list,
+                int(is_first_sent_apart))
+
+        except Exception as err:
+            import traceback
+            log.error("Could not plot variables")
+            log.error(err)
+            traceback.print_exc()
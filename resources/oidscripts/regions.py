@@ -0,0 +1,102 @@
+# -*- coding: utf-8 -*-
+
+"""
+Methods to read parts of buffers, either because they are too large to be
+plotted whole or because their rows are followed by a large padding
+"""
+
+from oidscripts import sysinfo
+
+# Maximum number of pixels in the overview of a buffer that is too large to be
+# plotted whole
+MAX_OVERVIEW_PIXELS = 4096 * 4096
+
+# Rows are read one by one, so that their padding is skipped, if the row stride
+# is at least this many times the width (e.g. views into a larger image)
+MIN_PACKED_STRIDE_RATIO = 2
+
+
+def get_pixel_size(buffer_metadata):
+    """
+    Compute the pixel size in bytes
+    """
+    return sysinfo.get_channel_size(buffer_metadata['type']) * \
+        buffer_metadata['channels']
+
+
+def is_packed_read(buffer_metadata):
+    """
+    Check whether the rows of a buffer are read one by one and packed
+    """
+    return buffer_metadata['row_stride'] >= \
+        MIN_PACKED_STRIDE_RATIO * buffer_metadata['width']
+
+
+def get_read_size(buffer_metadata):
+    """
+    Compute the number of bytes read to plot the whole buffer
+    """
+    row_length = buffer_metadata['width'] if is_packed_read(buffer_metadata) \
+        else buffer_metadata['row_stride']
+    return row_length * buffer_metadata['height'] * \
+        get_pixel_size(buffer_metadata)
+
+
+def read_buffer(read_memory, address, buffer_metadata):
+    """
+    Read a whole buffer at 'address', using the debugger function
+    read_memory(address, size). If its rows are read one by one, the row
+    stride in 'buffer_metadata' is updated to match the packed rows.
+    """
+    if not is_packed_read(buffer_metadata):
+        return memoryview(read_memory(address,
+                                      get_read_size(buffer_metadata)))
+
+    region = (0, 0, buffer_metadata['width'], buffer_metadata['height'], 1)
+    contents = read_region(read_memory, address, buffer_metadata, region)
+    buffer_metadata['row_stride'] = buffer_metadata['width']
+
+    return contents
+
+
+def get_overview_region(buffer_metadata, memory_budget):
+    """
+    Get a region covering the whole buffer, sampled coarsely enough for the
+    rows to be read to fit in 'memory_budget' bytes. The region is a tuple
+    (x, y, width, height, downsampling), as expected by oid_plot_buffer.
+    """
+    width = buffer_metadata['width']
+    height = buffer_metadata['height']
+    row_size = width * get_pixel_size(buffer_metadata)
+
+    downsampling = 1
+    while downsampling < max(width, height):
+        sampled_rows = -(-height // downsampling)
+        sampled_columns = -(-width // downsampling)
+        if sampled_rows * row_size <= memory_budget and \
+                sampled_rows * sampled_columns <= MAX_OVERVIEW_PIXELS:
+            break
+        downsampling *= 2
+
+    return 0, 0, width, height, downsampling
+
+
+def read_region(read_memory, address, buffer_metadata, region):
+    """
+    Read every downsampling-th row of a region of the buffer at 'address',
+    using the debugger function read_memory(address, size). Columns are
+    sampled by oid_plot_buffer, so each row is read whole.
+    """
+    x, y, width, height, downsampling = region
+    pixel_size = get_pixel_size(buffer_metadata)
+    row_stride = buffer_metadata['row_stride'] * pixel_size
+    row_size = width * pixel_size
+
+    rows = range(y, y + height, downsampling)
+    contents = bytearray(len(rows) * row_size)
+    for index, row in enumerate(rows):
+        row_address = address + row * row_stride + x * pixel_size
+        contents[index * row_size:(index + 1) * row_size] = \
+            read_memory(row_address, row_size)
+
+    return memoryview(contents)
@@ -155,6 +155,7 @@ class DummyDebugger(BridgeInterface):
 
         self._is_running = True
         self._incoming_request_queue = []
+        self._watched_requests = []
 
     def run_event_loop(self):
         if self._is_running:
@@ -165,6 +166,9 @@ class DummyDebugger(BridgeInterface):
                 latest_request = request_queue.pop(-1)
                 latest_request()
 
+            self._watched_requests = [request for request
+                                      in self._watched_requests if request()]
+
     def kill(self):
         """
         Request consumer thread to finish its execution
@@ -203,3 +207,10 @@ class DummyDebugger(BridgeInterface):
 
     def queue_request(self, callable_request):
         self._incoming_request_queue.append(callable_request)
+
+    def watch_descriptors(self, descriptors, callable_request):
+        """
+        The event loop is polled in this example, so watched requests simply
+        run on every iteration
+        """
+        self._watched_requests.append(callable_request)
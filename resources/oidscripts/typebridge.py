@@ -9,6 +9,7 @@ candidate oidtype and forwards the required calls from the debugger to it.
 import importlib
 import pkgutil
 
+from oidscripts import headerplan
 from oidscripts import oidtypes
 
 from oidscripts.oidtypes.interface import TypeInspectorInterface
@@ -30,26 +31,92 @@ class TypeBridge(object):
         for inspector_class in TypeInspectorInterface.__subclasses__():
             self._type_inspectors.append(inspector_class())
 
+        # Module able to process each type name, or None if there is none
+        self._type_inspector_cache = {}
+
+        # Compiled header plan of each type name, or None if its header cannot
+        # be read with a single memory read
+        self._header_plans = {}
+
+    def _get_type_inspector(self, symbol_obj, symbol_name):
+        """
+        Returns the module able to process a symbol. Modules are only queried
+        once per type name, since symbols of the same type are processed alike.
+        """
+        type_name = str(symbol_obj.type)
+        if type_name not in self._type_inspector_cache:
+            self._type_inspector_cache[type_name] = next(
+                (module for module in self._type_inspectors
+                 if module.is_symbol_observable(symbol_obj, symbol_name)),
+                None)
+
+        return self._type_inspector_cache[type_name]
+
+    def clear_type_inspector_cache(self):
+        """
+        Forget the module found for each type name. Must be called whenever
+        the debugger reloads the symbols, since type names may then refer to
+        different types.
+        """
+        self._type_inspector_cache.clear()
+
+    def clear_header_plans(self):
+        """
+        Forget the header plan compiled for each type name. Must be called
+        whenever the debugger reloads the symbols, since the layout of a type
+        may then have changed.
+        """
+        self._header_plans.clear()
+
     def get_buffer_metadata(self, symbol_name, picked_obj, debugger_bridge):
         """
         Returns the metadata related to a variable, which are required for the
         purpose of plotting it in the oidwindow
         """
-        for module in self._type_inspectors:
-            if module.is_symbol_observable(picked_obj, symbol_name):
-                return module.get_buffer_metadata(symbol_name,
-                                                  picked_obj,
-                                                  debugger_bridge)
+        module = self._get_type_inspector(picked_obj, symbol_name)
+        if module is None:
+            return None
+
+        header = self._read_header(module, picked_obj, debugger_bridge)
+        if header is not None:
+            return module.get_header_metadata(symbol_name, picked_obj, header)
+
+        return module.get_buffer_metadata(symbol_name,
+                                          picked_obj,
+                                          debugger_bridge)
+
+    def _read_header(self, module, picked_obj, debugger_bridge):
+        """
+        Read the header fields declared by 'module' with a single memory read.
+        The offsets of the fields are only resolved once per type name.
+        Returns None if the header must be read field by field instead.
+        """
+        if module.header_fields is None:
+            return None
+
+        type_name = str(picked_obj.type)
+        if type_name not in self._header_plans:
+            layout = debugger_bridge.get_header_layout(picked_obj,
+                                                       module.header_fields)
+            self._header_plans[type_name] = \
+                headerplan.compile_plan(*layout) if layout is not None \
+                else None
+
+        plan = self._header_plans[type_name]
+        if plan is None:
+            return None
 
-        return None
+        # Values that do not live in memory, such as the ones held in
+        # registers, have no address
+        address = debugger_bridge.get_object_address(picked_obj)
+        if address is None:
+            return None
+
+        return plan.decode(debugger_bridge.read_memory(address, plan.size))
 
     def is_symbol_observable(self, symbol_obj, symbol_name):
         """
         Returns true if any available module is able to process this particular
         symbol
         """
-        for module in self._type_inspectors:
-            if module.is_symbol_observable(symbol_obj, symbol_name):
-                return True
-
-        return False
+        return self._get_type_inspector(symbol_obj, symbol_name) is not None
@@ -46,13 +46,17 @@
 #define CHECK_FIELD_PROVIDED(name, current_ctx_name) \
     CHECK_FIELD_PROVIDED_RET(name, current_ctx_name, OID_EMPTY_PARAMETER)
 
-#define CHECK_FIELD_TYPE(name, type_checker_funct, current_ctx_name)    \
-    if (type_checker_funct(py_##name) == 0) {                           \
-        RAISE_PY_EXCEPTION(                                             \
-            PyExc_TypeError,                                            \
-            "Key " #name " provided to " current_ctx_name " does not "  \
-            "have the expected type (" #type_checker_funct " failed)"); \
-        return;                                                         \
+#define CHECK_FIELD_TYPE_RET(name, type_checker_funct, current_ctx_name, ret) \
+    if (type_checker_funct(py_##name) == 0) {                                 \
+        RAISE_PY_EXCEPTION(                                                   \
+            PyExc_TypeError,                                                  \
+            "Key " #name " provided to " current_ctx_name " does not "        \
+            "have the expected type (" #type_checker_funct " failed)");       \
+        return ret;                                                           \
     }
 
+#define CHECK_FIELD_TYPE(name, type_checker_funct, current_ctx_name) \
+    CHECK_FIELD_TYPE_RET(                                            \
+        name, type_checker_funct, current_ctx_name, OID_EMPTY_PARAMETER)
+
 #endif // PREPROCESSOR_DIRECTIVES_H_
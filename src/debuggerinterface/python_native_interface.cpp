@@ -28,10 +28,11 @@
 namespace oid
 {
 
-long get_py_int(PyObject* obj)
+std::int64_t get_py_int(PyObject* obj)
 {
 #if PY_MAJOR_VERSION == 3
-    return PyLong_AS_LONG(obj);
+    // long is only 32-bit wide on Windows
+    return static_cast<std::int64_t>(PyLong_AsLongLong(obj));
 #else
 #error "Unsupported Python version"
 #endif
@@ -26,6 +26,7 @@
 #ifndef PYTHON_NATIVE_INTERFACE_H_
 #define PYTHON_NATIVE_INTERFACE_H_
 
+#include <cstdint>
 #include <string>
 
 #include <Python.h>
@@ -40,7 +41,7 @@
 namespace oid
 {
 
-long get_py_int(PyObject* obj);
+std::int64_t get_py_int(PyObject* obj);
 
 
 int check_py_string_type(PyObject* obj);
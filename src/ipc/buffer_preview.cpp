@@ -0,0 +1,211 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "buffer_preview.h"
+
+#include <cstring>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace oid
+{
+
+namespace
+{
+
+struct PreviewGeometry
+{
+    std::int64_t width{};
+    std::int64_t height{};
+    int channels{};
+    std::int64_t stride{};
+    int downsampling{};
+};
+
+
+// Sums over max_preview_downsampling² pixels must not overflow
+template <typename T>
+using Accumulator =
+    std::conditional_t<std::is_floating_point_v<T>,
+                       T,
+                       std::conditional_t<sizeof(T) < sizeof(std::int32_t),
+                                          std::int32_t,
+                                          std::int64_t>>;
+
+
+template <typename T>
+T average(const Accumulator<T> sum, const int count)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return sum / static_cast<T>(count);
+    } else {
+        const auto half = static_cast<Accumulator<T>>(count / 2);
+        return static_cast<T>((sum >= 0 ? sum + half : sum - half) / count);
+    }
+}
+
+
+template <typename T>
+void downsample(const std::uint8_t* buffer,
+                const PreviewGeometry& geometry,
+                std::uint8_t* preview)
+{
+    const auto [width, height, channels, stride, downsampling] = geometry;
+
+    const auto preview_width  = preview_dimension(width, downsampling);
+    const auto preview_height = preview_dimension(height, downsampling);
+    const auto preview_row_length =
+        static_cast<std::size_t>(preview_width) * channels;
+    const auto row_length = static_cast<std::size_t>(stride) * channels;
+
+    auto sums = std::vector<Accumulator<T>>(preview_row_length);
+    auto row  = std::vector<T>(static_cast<std::size_t>(width) * channels);
+    auto preview_row = std::vector<T>(preview_row_length);
+
+    for (std::int64_t py = 0; py < preview_height; ++py) {
+        std::ranges::fill(sums, Accumulator<T>{});
+
+        const auto y_begin = py * downsampling;
+        const auto y_end   = std::min(y_begin + downsampling, height);
+
+        for (auto y = y_begin; y < y_end; ++y) {
+            // The source may not be aligned to T
+            std::memcpy(row.data(),
+                        buffer + y * row_length * sizeof(T),
+                        row.size() * sizeof(T));
+
+            // Accumulate the row into the sums of the blocks it crosses
+            for (std::int64_t px = 0; px < preview_width; ++px) {
+                const auto block_width =
+                    static_cast<int>(std::min<std::int64_t>(
+                        downsampling, width - px * downsampling));
+                const auto* block =
+                    row.data() +
+                    static_cast<std::size_t>(px) * downsampling * channels;
+                auto* sum =
+                    sums.data() + static_cast<std::size_t>(px) * channels;
+
+                for (int x = 0; x < block_width; ++x) {
+                    for (int c = 0; c < channels; ++c) {
+                        sum[c] += block[x * channels + c];
+                    }
+                }
+            }
+        }
+
+        const auto block_height = static_cast<int>(y_end - y_begin);
+        for (std::int64_t px = 0; px < preview_width; ++px) {
+            const auto block_width = static_cast<int>(std::min<std::int64_t>(
+                downsampling, width - px * downsampling));
+            const auto count = block_width * block_height;
+
+            for (int c = 0; c < channels; ++c) {
+                const auto index = static_cast<std::size_t>(px) * channels + c;
+                preview_row[index] = average<T>(sums[index], count);
+            }
+        }
+
+        std::memcpy(preview + py * preview_row_length * sizeof(T),
+                    preview_row.data(),
+                    preview_row_length * sizeof(T));
+    }
+}
+
+} // namespace
+
+
+std::vector<std::uint8_t> downsample_buffer(const std::uint8_t* buffer,
+                                            const std::int64_t width,
+                                            const std::int64_t height,
+                                            const int channels,
+                                            const std::int64_t stride,
+                                            const BufferType type,
+                                            const int downsampling)
+{
+    const auto preview_size =
+        static_cast<std::size_t>(preview_dimension(width, downsampling)) *
+        static_cast<std::size_t>(preview_dimension(height, downsampling)) *
+        static_cast<std::size_t>(channels) * type_size(type);
+
+    auto preview = std::vector<std::uint8_t>(preview_size);
+
+    const auto geometry =
+        PreviewGeometry{width, height, channels, stride, downsampling};
+
+    switch (type) {
+    case BufferType::UnsignedByte:
+        downsample<std::uint8_t>(buffer, geometry, preview.data());
+        break;
+    case BufferType::UnsignedShort:
+        downsample<std::uint16_t>(buffer, geometry, preview.data());
+        break;
+    case BufferType::Short:
+        downsample<std::int16_t>(buffer, geometry, preview.data());
+        break;
+    case BufferType::Int32:
+        downsample<std::int32_t>(buffer, geometry, preview.data());
+        break;
+    case BufferType::Float32:
+        downsample<float>(buffer, geometry, preview.data());
+        break;
+    case BufferType::Float64:
+        downsample<double>(buffer, geometry, preview.data());
+        break;
+    }
+
+    return preview;
+}
+
+
+std::vector<std::uint8_t> sample_region_columns(const std::uint8_t* rows,
+                                                const BufferRegion& region,
+                                                const std::size_t pixel_size)
+{
+    const auto sampled_width =
+        static_cast<std::size_t>(region.sampled_width());
+    const auto sampled_height =
+        static_cast<std::size_t>(region.sampled_height());
+    const auto row_size =
+        static_cast<std::size_t>(region.width) * pixel_size;
+    const auto step =
+        static_cast<std::size_t>(region.downsampling) * pixel_size;
+
+    auto sampled = std::vector<std::uint8_t>(sampled_width * sampled_height *
+                                             pixel_size);
+
+    auto* dst = sampled.data();
+    for (std::size_t y = 0; y < sampled_height; ++y) {
+        const auto* src = rows + y * row_size;
+        for (std::size_t x = 0; x < sampled_width; ++x) {
+            std::memcpy(dst, src + x * step, pixel_size);
+            dst += pixel_size;
+        }
+    }
+
+    return sampled;
+}
+
+} // namespace oid
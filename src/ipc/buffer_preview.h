@@ -0,0 +1,118 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef BUFFER_PREVIEW_H_
+#define BUFFER_PREVIEW_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include "raw_data_decode.h"
+
+namespace oid
+{
+
+/**
+ * Largest supported reduction factor along each dimension
+ */
+constexpr int max_preview_downsampling = 16;
+
+/**
+ * Number of pixels along one dimension of a preview, given the corresponding
+ * dimension of the full resolution buffer
+ */
+constexpr std::int64_t preview_dimension(const std::int64_t size,
+                                         const int downsampling)
+{
+    return (size + downsampling - 1) / downsampling;
+}
+
+/**
+ * Rectangle of a buffer, in full resolution pixels, sampled every downsampling
+ * pixels along each axis. Previews cover the whole buffer; buffers too large to
+ * be sent whole are transferred one region at a time.
+ */
+struct BufferRegion
+{
+    std::int64_t x{};
+    std::int64_t y{};
+    std::int64_t width{};
+    std::int64_t height{};
+    int downsampling{1};
+
+    bool operator==(const BufferRegion&) const = default;
+
+    [[nodiscard]] std::int64_t sampled_width() const
+    {
+        return preview_dimension(width, downsampling);
+    }
+
+    [[nodiscard]] std::int64_t sampled_height() const
+    {
+        return preview_dimension(height, downsampling);
+    }
+
+    /**
+     * @return true if this region covers other with at least as much detail
+     */
+    [[nodiscard]] bool contains(const BufferRegion& other) const
+    {
+        return downsampling <= other.downsampling && x <= other.x &&
+               y <= other.y && x + width >= other.x + other.width &&
+               y + height >= other.y + other.height;
+    }
+};
+
+/**
+ * Box filter a buffer into a preview with 1/downsampling² of its pixels. Each
+ * preview pixel is the average of a downsampling x downsampling block; blocks
+ * on the right and bottom borders may be smaller.
+ * @param stride row stride of the source buffer, in pixels
+ * @return preview contents, with the same type and channels as the source and
+ *     rows tightly packed
+ */
+std::vector<std::uint8_t> downsample_buffer(const std::uint8_t* buffer,
+                                            std::int64_t width,
+                                            std::int64_t height,
+                                            int channels,
+                                            std::int64_t stride,
+                                            BufferType type,
+                                            int downsampling);
+
+/**
+ * Keep every region.downsampling-th pixel of the rows read from a region
+ * @param rows sampled rows of the region, each holding region.width pixels
+ * @param pixel_size size of a pixel, in bytes
+ * @return pixels of the region, with rows tightly packed
+ */
+std::vector<std::uint8_t> sample_region_columns(const std::uint8_t* rows,
+                                                const BufferRegion& region,
+                                                std::size_t pixel_size);
+
+} // namespace oid
+
+#endif // BUFFER_PREVIEW_H_
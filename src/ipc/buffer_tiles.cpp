@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "buffer_tiles.h"
+
+#include <cassert>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace oid
+{
+
+namespace
+{
+
+constexpr auto hash_prime_1 = std::uint64_t{0x9E3779B185EBCA87ULL};
+constexpr auto hash_prime_2 = std::uint64_t{0xC2B2AE3D27D4EB4FULL};
+constexpr auto hash_prime_3 = std::uint64_t{0x165667B19E3779F9ULL};
+
+std::uint64_t mix_word(std::uint64_t hash, const std::uint64_t word)
+{
+    hash ^= std::rotl(word * hash_prime_2, 31) * hash_prime_1;
+    return std::rotl(hash, 27) * hash_prime_1 + hash_prime_3;
+}
+
+} // namespace
+
+
+std::uint64_t hash_bytes(const std::uint8_t* data, const std::size_t length)
+{
+    auto hash = hash_prime_3 ^ (length * hash_prime_1);
+
+    // Four independent lanes keep the multiplications pipelined
+    auto lanes = std::array<std::uint64_t, 4>{
+        hash, hash + hash_prime_1, hash + hash_prime_2, hash - hash_prime_1};
+
+    constexpr auto stripe_size = sizeof(std::uint64_t) * 4;
+    auto offset                = std::size_t{0};
+    for (; offset + stripe_size <= length; offset += stripe_size) {
+        for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+            auto word = std::uint64_t{};
+            std::memcpy(
+                &word, data + offset + lane * sizeof(word), sizeof(word));
+            lanes[lane] = mix_word(lanes[lane], word);
+        }
+    }
+
+    for (const auto lane : lanes) {
+        hash = mix_word(hash, lane);
+    }
+
+    for (; offset < length; ++offset) {
+        hash = mix_word(hash, data[offset]);
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= hash_prime_2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+
+std::vector<std::uint64_t> hash_buffer_tiles(const std::uint8_t* buffer,
+                                             const std::size_t length)
+{
+    auto hashes = std::vector<std::uint64_t>{};
+    hashes.reserve((length + buffer_tile_size - 1) / buffer_tile_size);
+
+    for (auto offset = std::size_t{0}; offset < length;
+         offset += buffer_tile_size) {
+        hashes.push_back(hash_bytes(
+            buffer + offset, std::min(buffer_tile_size, length - offset)));
+    }
+
+    return hashes;
+}
+
+
+std::vector<BufferTileRange>
+find_changed_tiles(const std::vector<std::uint64_t>& previous_hashes,
+                   const std::vector<std::uint64_t>& current_hashes,
+                   const std::size_t length)
+{
+    assert(previous_hashes.size() == current_hashes.size());
+
+    auto ranges = std::vector<BufferTileRange>{};
+
+    for (std::size_t tile = 0; tile < current_hashes.size(); ++tile) {
+        if (previous_hashes[tile] == current_hashes[tile]) {
+            continue;
+        }
+
+        const auto offset = tile * buffer_tile_size;
+        const auto size   = std::min(buffer_tile_size, length - offset);
+
+        if (!ranges.empty() &&
+            ranges.back().offset + ranges.back().length == offset) {
+            ranges.back().length += size;
+        } else {
+            ranges.push_back({offset, size});
+        }
+    }
+
+    return ranges;
+}
+
+} // namespace oid
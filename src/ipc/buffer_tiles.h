@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef BUFFER_TILES_H_
+#define BUFFER_TILES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace oid
+{
+
+/**
+ * Granularity, in bytes, in which buffer payloads are compared between two
+ * consecutive plots of the same symbol. Multiple of sizeof(double), so that a
+ * tile never splits an element.
+ */
+constexpr std::size_t buffer_tile_size = 64 * 1024;
+
+struct BufferTileRange
+{
+    std::size_t offset{};
+    std::size_t length{};
+};
+
+std::uint64_t hash_bytes(const std::uint8_t* data, std::size_t length);
+
+/**
+ * Hash each buffer_tile_size block of a buffer (the last one may be shorter)
+ */
+std::vector<std::uint64_t> hash_buffer_tiles(const std::uint8_t* buffer,
+                                             std::size_t length);
+
+/**
+ * Compare the tile hashes of two versions of the same buffer
+ * @return byte ranges covering the tiles that differ, with adjacent tiles
+ *     merged into a single range
+ */
+std::vector<BufferTileRange>
+find_changed_tiles(const std::vector<std::uint64_t>& previous_hashes,
+                   const std::vector<std::uint64_t>& current_hashes,
+                   std::size_t length);
+
+} // namespace oid
+
+#endif // BUFFER_TILES_H_
@@ -22,29 +22,211 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
  * IN THE SOFTWARE.
  */
-
 #include "message_exchange.h"
 
-#include <utility>
+#include <algorithm>
+
+#if defined(Q_OS_UNIX)
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace oid
 {
 
-MessageBlock::~MessageBlock() = default;
+namespace
+{
+
+constexpr auto socket_timeout_msecs = 30000;
+
+#if defined(Q_OS_UNIX)
+
+/**
+ * Batches frame segments into a single sendmsg call. The socket descriptor is
+ * non-blocking, since it is owned by Qt, so partial writes wait on poll.
+ */
+class GatherWriter
+{
+  public:
+    explicit GatherWriter(const int descriptor)
+        : descriptor_{descriptor}
+    {
+    }
+
+    void add(const uint8_t* data, const std::size_t size)
+    {
+        if (vector_count_ == vectors_.size()) {
+            flush();
+        }
+
+        vectors_[vector_count_++] = {
+            const_cast<uint8_t*>(data), // NOLINT: iovec is not const
+            size};
+    }
+
+    bool flush()
+    {
+        auto first_vector = std::size_t{0};
+        while (is_healthy_ && first_vector < vector_count_) {
+            auto message    = msghdr{};
+            message.msg_iov = vectors_.data() + first_vector;
+            message.msg_iovlen =
+                static_cast<decltype(message.msg_iovlen)>(vector_count_ -
+                                                          first_vector);
+
+            auto written = sendmsg(descriptor_, &message, send_flags);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                is_healthy_ = (errno == EAGAIN || errno == EWOULDBLOCK) &&
+                              wait_writable();
+                continue;
+            }
+
+            // Skip fully written vectors and trim the partially written one
+            while (first_vector < vector_count_ &&
+                   static_cast<std::size_t>(written) >=
+                       vectors_[first_vector].iov_len) {
+                written -= static_cast<ssize_t>(vectors_[first_vector].iov_len);
+                ++first_vector;
+            }
+            if (first_vector < vector_count_) {
+                auto& partial_vector = vectors_[first_vector];
+                partial_vector.iov_base =
+                    static_cast<uint8_t*>(partial_vector.iov_base) + written;
+                partial_vector.iov_len -= static_cast<std::size_t>(written);
+            }
+        }
+
+        vector_count_ = 0;
+        return is_healthy_;
+    }
+
+  private:
+    // Closed peers must not raise SIGPIPE in the debugger process
+#if defined(MSG_NOSIGNAL)
+    static constexpr int send_flags = MSG_NOSIGNAL;
+#else
+    static constexpr int send_flags = 0;
+#endif
+
+    int descriptor_{};
+    bool is_healthy_{true};
+
+    std::array<iovec, 64> vectors_{};
+    std::size_t vector_count_{};
 
-StringBlock::StringBlock(std::string value)
-    : data_{std::move(value)}
+    [[nodiscard]] bool wait_writable() const
+    {
+        auto descriptor_poll = pollfd{descriptor_, POLLOUT, 0};
+        return poll(&descriptor_poll, 1, socket_timeout_msecs) > 0 &&
+               (descriptor_poll.revents & POLLOUT) != 0;
+    }
+};
+
+#endif
+
+} // namespace
+
+
+bool MessageComposer::send(QTcpSocket* socket) const
 {
+    const auto frame_length_value = frame_length();
+    const auto frame_prefix =
+        std::bit_cast<const uint8_t*>(&frame_length_value);
+
+#if defined(Q_OS_UNIX)
+    // Bytes still queued in the socket must go out before the ones written
+    // directly to its descriptor
+    while (socket->bytesToWrite() > 0 &&
+           socket->waitForBytesWritten(socket_timeout_msecs)) {
+    }
+
+    if (const auto descriptor = socket->socketDescriptor();
+        descriptor != -1 && socket->bytesToWrite() == 0) {
+        return send(static_cast<int>(descriptor));
+    }
+#endif
+
+    // Qt appends every segment to its write buffer, which is then flushed
+    // at once
+    auto is_buffered =
+        socket->write(reinterpret_cast<const char*>(frame_prefix),
+                      static_cast<qint64>(sizeof(frame_length_value))) ==
+        static_cast<qint64>(sizeof(frame_length_value));
+    for_each_segment([&](const uint8_t* data, const std::size_t size) {
+        is_buffered = is_buffered &&
+                      socket->write(reinterpret_cast<const char*>(data),
+                                    static_cast<qint64>(size)) ==
+                          static_cast<qint64>(size);
+    });
+
+    while (socket->bytesToWrite() > 0 &&
+           socket->waitForBytesWritten(socket_timeout_msecs)) {
+    }
+
+    return is_buffered && socket->bytesToWrite() == 0;
 }
 
-size_t StringBlock::size() const
+
+#if defined(Q_OS_UNIX)
+bool MessageComposer::send(const int descriptor) const
 {
-    return data_.size();
+    const auto frame_length_value = frame_length();
+
+    auto writer = GatherWriter{descriptor};
+    writer.add(std::bit_cast<const uint8_t*>(&frame_length_value),
+               sizeof(frame_length_value));
+    for_each_segment([&](const uint8_t* data, const std::size_t size) {
+        writer.add(data, size);
+    });
+
+    return writer.flush();
 }
+#endif
 
-const uint8_t* StringBlock::data() const
+
+bool FrameAssembler::receive(QTcpSocket* socket, MessageFrame& frame)
 {
-    return reinterpret_cast<const uint8_t*>(data_.data());
+    const auto read_available = [&](uint8_t* dst, const std::size_t length) {
+        const auto read_length = socket->read(reinterpret_cast<char*>(dst),
+                                              static_cast<qint64>(length));
+        received_ += static_cast<std::size_t>(std::max(read_length, qint64{0}));
+    };
+
+    // Length prefix
+    constexpr auto prefix_size = sizeof(frame_length_);
+    if (received_ < prefix_size) {
+        read_available(std::bit_cast<uint8_t*>(&frame_length_) + received_,
+                       prefix_size - received_);
+        if (received_ < prefix_size) {
+            return false;
+        }
+
+        // Storage is left uninitialized, since it is about to be overwritten
+        frame_.data = std::make_unique_for_overwrite<uint8_t[]>(frame_length_);
+        frame_.size = frame_length_;
+    }
+
+    // Message body
+    const auto body_received = received_ - prefix_size;
+    if (body_received < frame_length_) {
+        read_available(frame_.data.get() + body_received,
+                       frame_length_ - body_received);
+        if (received_ < prefix_size + frame_length_) {
+            return false;
+        }
+    }
+
+    frame     = std::move(frame_);
+    frame_    = MessageFrame{};
+    received_ = 0;
+
+    return true;
 }
 
 } // namespace oid
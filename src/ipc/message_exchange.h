@@ -26,88 +26,63 @@
 #ifndef IPC_MESSAGE_EXCHANGE_H_
 #define IPC_MESSAGE_EXCHANGE_H_
 
+#include <cstdint>
+#include <cstring>
+
+#include <array>
 #include <bit>
 #include <deque>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <QTcpSocket>
 
+#include "buffer_preview.h"
+#include "payload_codec.h"
 #include "raw_data_decode.h"
 
 namespace oid
 {
 
 enum class MessageType {
-    GetObservedSymbols         = 0,
-    GetObservedSymbolsResponse = 1,
-    SetAvailableSymbols        = 2,
-    PlotBufferContents         = 3,
-    PlotBufferRequest          = 4
-};
-
-struct MessageBlock
-{
-    [[nodiscard]] virtual std::size_t size() const    = 0;
-    [[nodiscard]] virtual const uint8_t* data() const = 0;
-    virtual ~MessageBlock();
-};
-
-template <typename Primitive>
-struct PrimitiveBlock final : MessageBlock
-{
-    explicit PrimitiveBlock(Primitive value)
-        : data_{value}
-    {
-    }
-
-    [[nodiscard]] std::size_t size() const override
-    {
-        return sizeof(Primitive);
-    }
-
-    [[nodiscard]] const uint8_t* data() const override
-    {
-        return std::bit_cast<const uint8_t*>(&data_);
-    }
-
-  private:
-    Primitive data_{};
+    GetObservedSymbols           = 0,
+    GetObservedSymbolsResponse   = 1,
+    SetAvailableSymbols          = 2,
+    PlotBufferContents           = 3,
+    PlotBufferRequest            = 4,
+    PlotBufferSharedContents     = 5,
+    PlotBufferTiles              = 6,
+    WindowCapabilities           = 7,
+    PlotBufferCompressedContents = 8,
+    PlotBufferPreview            = 9,
+    PlotBufferRegion             = 10,
+    PlotBufferRegionRequest      = 11,
+    PlotBufferBatch              = 12,
+    PlotBufferBatchRequest       = 13,
+    PlotBufferUnchanged          = 14,
+    UpdateAvailableSymbols       = 15,
+    AvailableSymbolsRequest      = 16
 };
 
-
-struct StringBlock final : MessageBlock
+/**
+ * Description of a buffer plotted by the debugger, sent ahead of its contents.
+ * Dimensions are 64-bit, so that sizes and offsets computed from them do not
+ * overflow for buffers larger than 2 GiB.
+ */
+struct BufferMetadata
 {
-    explicit StringBlock(std::string value);
-
-    [[nodiscard]] std::size_t size() const override;
-
-    [[nodiscard]] const uint8_t* data() const override;
-
-  private:
-    std::string data_{};
-};
-
-struct BufferBlock final : MessageBlock
-{
-    BufferBlock(const uint8_t* buffer, const std::size_t length)
-        : buffer_{buffer}
-        , length_{length}
-    {
-    }
-
-    [[nodiscard]] std::size_t size() const override
-    {
-        return length_;
-    }
-
-    [[nodiscard]] const uint8_t* data() const override
-    {
-        return buffer_;
-    }
-
-  private:
-    const uint8_t* buffer_{};
-    std::size_t length_{};
+    std::string variable_name{};
+    std::string display_name{};
+    std::string pixel_layout{};
+    bool transpose{};
+    std::int64_t width{};
+    std::int64_t height{};
+    int channels{};
+    std::int64_t stride{};
+    BufferType type{};
+
+    bool operator==(const BufferMetadata&) const = default;
 };
 
 template <typename PrimitiveType>
@@ -115,13 +90,23 @@ void assert_primitive_type()
 {
     static_assert(std::is_same_v<PrimitiveType, MessageType> ||
                       std::is_same_v<PrimitiveType, int> ||
+                      std::is_same_v<PrimitiveType, std::int64_t> ||
                       std::is_same_v<PrimitiveType, unsigned char> ||
                       std::is_same_v<PrimitiveType, BufferType> ||
+                      std::is_same_v<PrimitiveType, PayloadCodec> ||
                       std::is_same_v<PrimitiveType, bool> ||
                       std::is_same_v<PrimitiveType, std::size_t>,
                   "this function must only be called with primitives");
 }
 
+/**
+ * Serializes a message into a single frame, prefixed by its length in bytes.
+ *
+ * Primitives and strings are copied into an inline arena, so composing a
+ * message without payload does not allocate. Buffer payloads are referenced,
+ * not copied, and must outlive the call to send(), which writes the whole
+ * frame with as few system calls as possible.
+ */
 class MessageComposer
 {
   public:
@@ -130,7 +115,7 @@ class MessageComposer
     {
         assert_primitive_type<PrimitiveType>();
 
-        message_blocks_.emplace_back(new PrimitiveBlock<PrimitiveType>(value));
+        append(std::bit_cast<const uint8_t*>(&value), sizeof(PrimitiveType));
 
         return *this;
     }
@@ -138,43 +123,150 @@ class MessageComposer
     MessageComposer& push(const uint8_t* buffer, const std::size_t size)
     {
         push(size);
-        message_blocks_.emplace_back(new BufferBlock(buffer, size));
+        payloads_.push_back({arena_size_, buffer, size});
 
         return *this;
     }
 
-    void send(QTcpSocket* socket) const
+    /**
+     * @return false if the frame could not be written whole, in which case
+     *     the peer can no longer tell where the next frames start
+     */
+    [[nodiscard]] bool send(QTcpSocket* socket) const;
+
+#if defined(Q_OS_UNIX)
+    /**
+     * Write the frame to the native descriptor of a connected socket, without
+     * going through its socket object. Safe to call from a thread other than
+     * the one owning the socket object, as long as nothing is written through
+     * that object.
+     *
+     * @return false if the frame could not be written whole
+     */
+    [[nodiscard]] bool send(int descriptor) const;
+#endif
+
+    void clear()
+    {
+        heap_arena_.clear();
+        payloads_.clear();
+        arena_size_ = 0;
+    }
+
+  private:
+    struct PayloadSpan
+    {
+        std::size_t arena_offset{};
+        const uint8_t* data{};
+        std::size_t size{};
+    };
+
+    static constexpr std::size_t inline_arena_capacity = 256;
+
+    std::array<uint8_t, inline_arena_capacity> inline_arena_{};
+    std::vector<uint8_t> heap_arena_{};
+    std::size_t arena_size_{};
+
+    std::vector<PayloadSpan> payloads_{};
+
+    [[nodiscard]] const uint8_t* arena() const
+    {
+        return heap_arena_.empty() ? inline_arena_.data() : heap_arena_.data();
+    }
+
+    void append(const uint8_t* data, const std::size_t size)
     {
-        for (const auto& block : message_blocks_) {
-            auto offset = qint64{0};
-            do {
-                offset +=
-                    socket->write(reinterpret_cast<const char*>(block->data()),
-                                  static_cast<qint64>(block->size()));
-
-                if (offset < static_cast<qint64>(block->size())) {
-                    socket->waitForBytesWritten();
-                }
-            } while (offset < static_cast<qint64>(block->size()));
+        if (heap_arena_.empty() &&
+            arena_size_ + size <= inline_arena_capacity) {
+            std::memcpy(inline_arena_.data() + arena_size_, data, size);
+        } else {
+            if (heap_arena_.empty()) {
+                heap_arena_.assign(inline_arena_.begin(),
+                                   inline_arena_.begin() + arena_size_);
+            }
+            heap_arena_.insert(heap_arena_.end(), data, data + size);
         }
 
-        socket->waitForBytesWritten();
+        arena_size_ += size;
     }
 
-    void clear()
+    /**
+     * Call visitor(data, size) for each contiguous segment of the frame, in
+     * the order in which they must be written, excluding the length prefix
+     */
+    template <typename Visitor>
+    void for_each_segment(Visitor&& visitor) const
+    {
+        auto arena_offset = std::size_t{0};
+        for (const auto& payload : payloads_) {
+            if (payload.arena_offset > arena_offset) {
+                visitor(arena() + arena_offset,
+                        payload.arena_offset - arena_offset);
+            }
+            if (payload.size > 0) {
+                visitor(payload.data, payload.size);
+            }
+            arena_offset = payload.arena_offset;
+        }
+
+        if (arena_size_ > arena_offset) {
+            visitor(arena() + arena_offset, arena_size_ - arena_offset);
+        }
+    }
+
+    [[nodiscard]] std::size_t frame_length() const
     {
-        message_blocks_.clear();
+        auto length = arena_size_;
+        for (const auto& payload : payloads_) {
+            length += payload.size;
+        }
+        return length;
     }
+};
+
+/**
+ * A complete message, as received from the socket, without its length prefix
+ */
+struct MessageFrame
+{
+    std::unique_ptr<uint8_t[]> data{};
+    std::size_t size{};
+};
+
+
+/**
+ * Assembles length-prefixed frames from a socket without ever blocking. Each
+ * call consumes whatever bytes are available and resumes where the previous
+ * one stopped.
+ */
+class FrameAssembler
+{
+  public:
+    /**
+     * Read the bytes available in the socket
+     * @param socket socket to read from
+     * @param frame receives the next message if it has been fully received
+     * @return true if a complete frame was moved into frame
+     */
+    [[nodiscard]] bool receive(QTcpSocket* socket, MessageFrame& frame);
 
   private:
-    std::deque<std::unique_ptr<MessageBlock>> message_blocks_{};
+    std::size_t frame_length_{};
+    std::size_t received_{};
+    MessageFrame frame_{};
 };
 
+
+/**
+ * Decodes the fields of a frame, in the order they were pushed to the
+ * MessageComposer. Reading past the end of the frame yields zeroed values and
+ * flags the decoder as invalid.
+ */
 class MessageDecoder
 {
   public:
-    explicit MessageDecoder(QTcpSocket* socket)
-        : socket_{socket}
+    explicit MessageDecoder(const MessageFrame& frame)
+        : frame_{frame}
     {
     }
 
@@ -183,7 +275,7 @@ class MessageDecoder
     {
         assert_primitive_type<PrimitiveType>();
 
-        read_impl(std::bit_cast<char*>(&value), sizeof(PrimitiveType));
+        read_impl(std::bit_cast<uint8_t*>(&value), sizeof(PrimitiveType));
 
         return *this;
     }
@@ -197,7 +289,8 @@ class MessageDecoder
             return num;
         }();
 
-        for (int s = 0; s < static_cast<int>(number_symbols); ++s) {
+        for (int s = 0; s < static_cast<int>(number_symbols) && is_valid_;
+             ++s) {
             const auto symbol_value = [&] {
                 auto value{StringType{}};
                 read(value);
@@ -210,20 +303,64 @@ class MessageDecoder
         return *this;
     }
 
+    /**
+     * Read raw bytes into a caller provided buffer. The size prefix written by
+     * MessageComposer::push(buffer, size) must have been read beforehand.
+     */
+    MessageDecoder& read(uint8_t* buffer, const std::size_t length)
+    {
+        read_impl(buffer, length);
+
+        return *this;
+    }
+
+    /**
+     * Locate a buffer pushed with MessageComposer::push(buffer, size) inside
+     * the frame, without copying it
+     * @param data receives a pointer into the frame, valid while it is alive
+     * @param size receives the buffer size, in bytes
+     */
+    MessageDecoder& read_view(uint8_t*& data, std::size_t& size)
+    {
+        read(size);
+
+        if (!has_remaining(size)) {
+            data = nullptr;
+            size = 0;
+            return *this;
+        }
+
+        data = frame_.data.get() + offset_;
+        offset_ += size;
+
+        return *this;
+    }
+
+    [[nodiscard]] bool is_valid() const
+    {
+        return is_valid_;
+    }
+
   private:
-    QTcpSocket* socket_{};
+    const MessageFrame& frame_;
+    std::size_t offset_{};
+    bool is_valid_{true};
+
+    [[nodiscard]] bool has_remaining(const std::size_t length)
+    {
+        is_valid_ = is_valid_ && length <= frame_.size - offset_;
+        return is_valid_;
+    }
 
-    void read_impl(char* dst, const std::size_t read_length) const
+    void read_impl(uint8_t* dst, const std::size_t read_length)
     {
-        auto offset = std::size_t{0};
-        do {
-            offset += socket_->read(dst + offset,
-                                    static_cast<qint64>(read_length - offset));
+        if (!has_remaining(read_length)) {
+            std::memset(dst, 0, read_length);
+            return;
+        }
 
-            if (offset < read_length) {
-                socket_->waitForReadyRead();
-            }
-        } while (offset < read_length);
+        std::memcpy(dst, frame_.data.get() + offset_, read_length);
+        offset_ += read_length;
     }
 };
 
@@ -232,7 +369,7 @@ inline MessageComposer&
 MessageComposer::push<std::string>(const std::string& value)
 {
     push(value.size());
-    message_blocks_.emplace_back(new StringBlock(value));
+    append(reinterpret_cast<const uint8_t*>(value.data()), value.size());
     return *this;
 }
 
@@ -247,6 +384,34 @@ inline MessageComposer& MessageComposer::push<std::deque<std::string>>(
     return *this;
 }
 
+template <>
+inline MessageComposer&
+MessageComposer::push<BufferMetadata>(const BufferMetadata& value)
+{
+    push(value.variable_name)
+        .push(value.display_name)
+        .push(value.pixel_layout)
+        .push(value.transpose)
+        .push(value.width)
+        .push(value.height)
+        .push(value.channels)
+        .push(value.stride)
+        .push(value.type);
+    return *this;
+}
+
+template <>
+inline MessageComposer&
+MessageComposer::push<BufferRegion>(const BufferRegion& value)
+{
+    push(value.x)
+        .push(value.y)
+        .push(value.width)
+        .push(value.height)
+        .push(value.downsampling);
+    return *this;
+}
+
 template <>
 inline MessageDecoder&
 MessageDecoder::read<std::vector<uint8_t>>(std::vector<uint8_t>& value)
@@ -257,8 +422,13 @@ MessageDecoder::read<std::vector<uint8_t>>(std::vector<uint8_t>& value)
         return size;
     }();
 
+    if (!has_remaining(container_size)) {
+        value.clear();
+        return *this;
+    }
+
     value.resize(container_size);
-    read_impl(reinterpret_cast<char*>(value.data()), container_size);
+    read_impl(value.data(), container_size);
 
     return *this;
 }
@@ -272,9 +442,41 @@ inline MessageDecoder& MessageDecoder::read<std::string>(std::string& value)
         return length;
     }();
 
+    if (!has_remaining(symbol_length)) {
+        value.clear();
+        return *this;
+    }
+
     value.resize(symbol_length);
-    read_impl(&value.front(), symbol_length);
+    read_impl(reinterpret_cast<uint8_t*>(value.data()), symbol_length);
+
+    return *this;
+}
+
+template <>
+inline MessageDecoder&
+MessageDecoder::read<BufferMetadata>(BufferMetadata& value)
+{
+    read(value.variable_name)
+        .read(value.display_name)
+        .read(value.pixel_layout)
+        .read(value.transpose)
+        .read(value.width)
+        .read(value.height)
+        .read(value.channels)
+        .read(value.stride)
+        .read(value.type);
+    return *this;
+}
 
+template <>
+inline MessageDecoder& MessageDecoder::read<BufferRegion>(BufferRegion& value)
+{
+    read(value.x)
+        .read(value.y)
+        .read(value.width)
+        .read(value.height)
+        .read(value.downsampling);
     return *this;
 }
 
@@ -287,10 +489,15 @@ inline MessageDecoder& MessageDecoder::read<QString>(QString& value)
         return length;
     }();
 
+    if (!has_remaining(symbol_length)) {
+        value.clear();
+        return *this;
+    }
+
     const auto temp_string = [&] {
         auto string = std::vector<char>{};
         string.resize(symbol_length + 1, '\0');
-        read_impl(string.data(), symbol_length);
+        read_impl(reinterpret_cast<uint8_t*>(string.data()), symbol_length);
         return string;
     }();
 
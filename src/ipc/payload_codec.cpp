@@ -0,0 +1,439 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "payload_codec.h"
+
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <thread>
+
+namespace oid
+{
+
+namespace
+{
+
+///
+// Byte shuffle
+
+void shuffle_bytes(const std::uint8_t* src,
+                   const std::size_t length,
+                   const std::size_t element_size,
+                   std::uint8_t* dst)
+{
+    const auto element_count = length / element_size;
+
+    for (std::size_t byte = 0; byte < element_size; ++byte) {
+        auto* plane = dst + byte * element_count;
+        for (std::size_t e = 0; e < element_count; ++e) {
+            plane[e] = src[e * element_size + byte];
+        }
+    }
+
+    // Trailing bytes that do not form a whole element are kept as is
+    const auto shuffled_length = element_count * element_size;
+    std::memcpy(dst + shuffled_length,
+                src + shuffled_length,
+                length - shuffled_length);
+}
+
+
+void unshuffle_bytes(const std::uint8_t* src,
+                     const std::size_t length,
+                     const std::size_t element_size,
+                     std::uint8_t* dst)
+{
+    const auto element_count = length / element_size;
+
+    for (std::size_t byte = 0; byte < element_size; ++byte) {
+        const auto* plane = src + byte * element_count;
+        for (std::size_t e = 0; e < element_count; ++e) {
+            dst[e * element_size + byte] = plane[e];
+        }
+    }
+
+    const auto shuffled_length = element_count * element_size;
+    std::memcpy(dst + shuffled_length,
+                src + shuffled_length,
+                length - shuffled_length);
+}
+
+
+///
+// LZ block codec, following the LZ4 block format: each sequence is a token
+// (literal length and match length nibbles), extra length bytes, literals, a
+// 16 bit match offset and extra match length bytes. The last sequence only
+// carries literals.
+
+constexpr std::size_t lz_min_match      = 4;
+constexpr std::size_t lz_last_literals  = 5;
+constexpr std::size_t lz_match_limit    = 12;
+constexpr std::size_t lz_max_offset     = 65535;
+constexpr std::size_t lz_hash_log       = 16;
+constexpr std::uint32_t lz_hash_factor  = 2654435761U;
+
+std::uint32_t read_u32(const std::uint8_t* src)
+{
+    auto value = std::uint32_t{};
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+
+std::size_t lz_hash(const std::uint32_t sequence)
+{
+    return (sequence * lz_hash_factor) >> (32 - lz_hash_log);
+}
+
+
+std::size_t lz_compress_bound(const std::size_t length)
+{
+    return length + length / 255 + 16;
+}
+
+
+void write_length(std::uint8_t*& op, std::size_t length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<std::uint8_t>(length);
+}
+
+
+void write_sequence(std::uint8_t*& op,
+                    const std::uint8_t* literals,
+                    const std::size_t literal_length,
+                    const std::size_t offset,
+                    const std::size_t match_length)
+{
+    auto* token = op++;
+
+    const auto literal_nibble = std::min<std::size_t>(literal_length, 15);
+    *token = static_cast<std::uint8_t>(literal_nibble << 4);
+    if (literal_nibble == 15) {
+        write_length(op, literal_length - 15);
+    }
+
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    // Last sequence
+    if (match_length == 0) {
+        return;
+    }
+
+    *op++ = static_cast<std::uint8_t>(offset & 0xFF);
+    *op++ = static_cast<std::uint8_t>(offset >> 8);
+
+    const auto match_nibble =
+        std::min<std::size_t>(match_length - lz_min_match, 15);
+    *token |= static_cast<std::uint8_t>(match_nibble);
+    if (match_nibble == 15) {
+        write_length(op, match_length - lz_min_match - 15);
+    }
+}
+
+
+std::uint64_t read_u64(const std::uint8_t* src)
+{
+    auto value = std::uint64_t{};
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+
+/**
+ * Length of the match between positions ref and ip, which are known to share
+ * their first lz_min_match bytes, without reaching past end
+ */
+std::size_t lz_match_length(const std::uint8_t* src,
+                            const std::size_t ref,
+                            const std::size_t ip,
+                            const std::size_t end)
+{
+    auto match_length = lz_min_match;
+
+    // Compare eight bytes at a time; on little endian hosts the first
+    // differing byte is given by the trailing zero bits of their difference
+    if constexpr (std::endian::native == std::endian::little) {
+        while (ip + match_length + sizeof(std::uint64_t) <= end) {
+            const auto difference = read_u64(src + ref + match_length) ^
+                                    read_u64(src + ip + match_length);
+            if (difference != 0) {
+                return match_length +
+                       static_cast<std::size_t>(std::countr_zero(difference)) /
+                           8;
+            }
+            match_length += sizeof(std::uint64_t);
+        }
+    }
+
+    while (ip + match_length < end &&
+           src[ref + match_length] == src[ip + match_length]) {
+        ++match_length;
+    }
+
+    return match_length;
+}
+
+
+std::size_t lz_compress(const std::uint8_t* src,
+                        const std::size_t length,
+                        std::uint8_t* dst,
+                        std::vector<std::uint32_t>& hash_table)
+{
+    std::fill(hash_table.begin(), hash_table.end(), 0);
+
+    auto* op    = dst;
+    auto ip     = std::size_t{0};
+    auto anchor = std::size_t{0};
+
+    if (length > lz_match_limit) {
+        const auto match_start_limit = length - lz_match_limit;
+        const auto match_end_limit   = length - lz_last_literals;
+
+        while (ip < match_start_limit) {
+            const auto sequence = read_u32(src + ip);
+            auto& entry         = hash_table[lz_hash(sequence)];
+            const auto ref      = static_cast<std::size_t>(entry);
+            entry               = static_cast<std::uint32_t>(ip);
+
+            if (ref >= ip || ip - ref > lz_max_offset ||
+                read_u32(src + ref) != sequence) {
+                // Skip faster through incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const auto match_length =
+                lz_match_length(src, ref, ip, match_end_limit);
+
+            write_sequence(
+                op, src + anchor, ip - anchor, ip - ref, match_length);
+
+            ip += match_length;
+            anchor = ip;
+        }
+    }
+
+    write_sequence(op, src + anchor, length - anchor, 0, 0);
+
+    return static_cast<std::size_t>(op - dst);
+}
+
+
+bool read_length(const std::uint8_t* src,
+                 const std::size_t src_length,
+                 std::size_t& ip,
+                 std::size_t& length)
+{
+    auto extra = std::uint8_t{255};
+    while (extra == 255) {
+        if (ip >= src_length) {
+            return false;
+        }
+        extra = src[ip++];
+        length += extra;
+    }
+    return true;
+}
+
+
+bool lz_decompress(const std::uint8_t* src,
+                   const std::size_t src_length,
+                   std::uint8_t* dst,
+                   const std::size_t dst_length)
+{
+    auto ip = std::size_t{0};
+    auto op = std::size_t{0};
+
+    while (ip < src_length) {
+        const auto token = src[ip++];
+
+        auto literal_length = static_cast<std::size_t>(token >> 4);
+        if (literal_length == 15 &&
+            !read_length(src, src_length, ip, literal_length)) {
+            return false;
+        }
+
+        if (literal_length > src_length - ip ||
+            literal_length > dst_length - op) {
+            return false;
+        }
+        std::memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // Last sequence
+        if (ip == src_length) {
+            break;
+        }
+
+        if (src_length - ip < 2) {
+            return false;
+        }
+        const auto offset = static_cast<std::size_t>(src[ip]) |
+                            (static_cast<std::size_t>(src[ip + 1]) << 8);
+        ip += 2;
+
+        auto match_length = static_cast<std::size_t>(token & 0x0F);
+        if (match_length == 15 &&
+            !read_length(src, src_length, ip, match_length)) {
+            return false;
+        }
+        match_length += lz_min_match;
+
+        if (offset == 0 || offset > op || match_length > dst_length - op) {
+            return false;
+        }
+
+        // Matches may overlap their own output, e.g. runs with offset 1. The
+        // repeated pattern is copied in doubling steps, each of which only
+        // reads bytes that are already written.
+        auto copied = std::size_t{0};
+        while (copied < match_length) {
+            const auto step = std::min(offset + copied, match_length - copied);
+            std::memcpy(dst + op + copied, dst + op - offset, step);
+            copied += step;
+        }
+        op += match_length;
+    }
+
+    return op == dst_length;
+}
+
+
+///
+// Parallel execution
+
+template <typename Task>
+void parallel_for(const std::size_t task_count, Task&& task)
+{
+    const auto thread_count = std::min<std::size_t>(
+        task_count, std::max(1U, std::thread::hardware_concurrency()));
+
+    auto next_task = std::atomic<std::size_t>{0};
+    const auto worker = [&] {
+        for (auto t = next_task++; t < task_count; t = next_task++) {
+            task(t);
+        }
+    };
+
+    auto workers = std::vector<std::thread>{};
+    for (std::size_t w = 1; w < thread_count; ++w) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+} // namespace
+
+
+std::vector<CompressedChunk> compress_payload(const std::uint8_t* data,
+                                              const std::size_t length,
+                                              const std::size_t element_size)
+{
+    const auto chunk_count =
+        (length + payload_codec_chunk_size - 1) / payload_codec_chunk_size;
+
+    auto chunks = std::vector<CompressedChunk>(chunk_count);
+
+    parallel_for(chunk_count, [&](const std::size_t c) {
+        const auto offset   = c * payload_codec_chunk_size;
+        const auto raw_size =
+            std::min(payload_codec_chunk_size, length - offset);
+
+        auto shuffled   = std::vector<std::uint8_t>(raw_size);
+        auto hash_table = std::vector<std::uint32_t>(1 << lz_hash_log);
+        shuffle_bytes(data + offset, raw_size, element_size, shuffled.data());
+
+        auto& chunk    = chunks[c];
+        chunk.raw_size = raw_size;
+        chunk.data.resize(lz_compress_bound(raw_size));
+        chunk.data.resize(lz_compress(
+            shuffled.data(), raw_size, chunk.data.data(), hash_table));
+
+        // Chunks that do not shrink are stored as is
+        if (chunk.data.size() >= raw_size) {
+            chunk.data.assign(data + offset, data + offset + raw_size);
+        }
+    });
+
+    return chunks;
+}
+
+
+bool decompress_payload(const std::vector<CompressedChunkView>& chunks,
+                        const std::size_t element_size,
+                        std::uint8_t* dst,
+                        const std::size_t length)
+{
+    // Chunk offsets in the destination buffer
+    auto offsets = std::vector<std::size_t>(chunks.size());
+    auto total   = std::size_t{0};
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+        offsets[c] = total;
+        total += chunks[c].raw_size;
+    }
+    if (total != length) {
+        return false;
+    }
+
+    auto is_valid = std::atomic<bool>{true};
+
+    parallel_for(chunks.size(), [&](const std::size_t c) {
+        const auto& chunk = chunks[c];
+        auto* chunk_dst   = dst + offsets[c];
+
+        if (chunk.size == chunk.raw_size) {
+            std::memcpy(chunk_dst, chunk.data, chunk.size);
+            return;
+        }
+
+        auto shuffled = std::vector<std::uint8_t>(chunk.raw_size);
+        if (!lz_decompress(
+                chunk.data, chunk.size, shuffled.data(), chunk.raw_size)) {
+            is_valid = false;
+            return;
+        }
+
+        unshuffle_bytes(
+            shuffled.data(), chunk.raw_size, element_size, chunk_dst);
+    });
+
+    return is_valid;
+}
+
+} // namespace oid
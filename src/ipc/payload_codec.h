@@ -0,0 +1,92 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef IPC_PAYLOAD_CODEC_H_
+#define IPC_PAYLOAD_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace oid
+{
+
+/**
+ * Codecs that can be applied to buffer payloads sent through the socket. The
+ * window announces the ones it supports when it connects to the bridge.
+ */
+enum class PayloadCodec {
+    None      = 0,
+    ShuffleLz = 1 // Byte shuffle followed by LZ4-style block compression
+};
+
+/**
+ * Payloads are split into chunks of this size, compressed and decompressed
+ * independently and in parallel
+ */
+constexpr std::size_t payload_codec_chunk_size = 4 << 20;
+
+struct CompressedChunk
+{
+    std::size_t raw_size{};
+    std::vector<std::uint8_t> data{}; // Same size as raw_size if stored as is
+};
+
+struct CompressedChunkView
+{
+    std::size_t raw_size{};
+    const std::uint8_t* data{};
+    std::size_t size{};
+};
+
+/**
+ * Compress a payload with the ShuffleLz codec
+ * @param data payload contents
+ * @param length payload size, in bytes
+ * @param element_size size of each element, used to group bytes of the same
+ *     significance together before compression
+ * @return one entry per payload_codec_chunk_size chunk
+ */
+std::vector<CompressedChunk> compress_payload(const std::uint8_t* data,
+                                              std::size_t length,
+                                              std::size_t element_size);
+
+/**
+ * Decompress a payload compressed by compress_payload
+ * @param chunks compressed chunks, in order
+ * @param element_size element size used for compression
+ * @param dst destination buffer
+ * @param length size of the destination buffer, in bytes
+ * @return false if the chunks are malformed or do not fill dst exactly
+ */
+bool decompress_payload(const std::vector<CompressedChunkView>& chunks,
+                        std::size_t element_size,
+                        std::uint8_t* dst,
+                        std::size_t length);
+
+} // namespace oid
+
+#endif // IPC_PAYLOAD_CODEC_H_
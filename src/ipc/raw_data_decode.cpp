@@ -35,11 +35,20 @@ namespace oid
 std::vector<std::uint8_t>
 make_float_buffer_from_double(const std::vector<std::uint8_t>& buff_double)
 {
-    const auto element_count = buff_double.size() / sizeof(double);
+    return make_float_buffer_from_double(buff_double.data(),
+                                         buff_double.size());
+}
+
+
+std::vector<std::uint8_t>
+make_float_buffer_from_double(const std::uint8_t* buff_double,
+                              const std::size_t length)
+{
+    const auto element_count = length / sizeof(double);
     std::vector<std::uint8_t> buff_float(element_count * sizeof(float));
 
     // Cast from double to float
-    const auto src = std::bit_cast<const double*>(buff_double.data());
+    const auto src = std::bit_cast<const double*>(buff_double);
     const auto dst = std::bit_cast<float*>(buff_float.data());
     for (std::size_t i = 0; i < element_count; ++i) {
         dst[i] = static_cast<float>(src[i]);
@@ -46,6 +46,10 @@ enum class BufferType {
 std::vector<std::uint8_t>
 make_float_buffer_from_double(const std::vector<std::uint8_t>& buff_double);
 
+std::vector<std::uint8_t>
+make_float_buffer_from_double(const std::uint8_t* buff_double,
+                              std::size_t length);
+
 std::size_t type_size(BufferType type);
 
 } // namespace oid
@@ -0,0 +1,107 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef IPC_RING_QUEUE_H_
+#define IPC_RING_QUEUE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace oid
+{
+
+/**
+ * Unbounded FIFO queue for a single thread, stored in a ring of slots that is
+ * only reallocated when it is full. Popped slots are reused by the following
+ * pushes, so a queue that is drained regularly stops allocating once it grew
+ * to its working size.
+ */
+template <typename T>
+class RingQueue
+{
+  public:
+    void push(T&& value)
+    {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+
+        slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(value);
+        ++size_;
+    }
+
+    [[nodiscard]] std::optional<T> try_pop()
+    {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+
+        // Leave a default constructed value behind, so that resources held by
+        // the element are released right away
+        auto value = std::exchange(slots_[head_], T{});
+        head_      = (head_ + 1) & (slots_.size() - 1);
+        --size_;
+
+        return value;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return size_;
+    }
+
+  private:
+    static constexpr std::size_t initial_capacity = 16;
+
+    // Power of two sized, so that indices wrap around with a mask
+    std::vector<T> slots_{};
+    std::size_t head_{0};
+    std::size_t size_{0};
+
+    void grow()
+    {
+        auto grown_slots =
+            std::vector<T>(std::max(initial_capacity, slots_.size() * 2));
+        for (std::size_t i = 0; i < size_; ++i) {
+            grown_slots[i] =
+                std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+        }
+
+        slots_ = std::move(grown_slots);
+        head_  = 0;
+    }
+};
+
+} // namespace oid
+
+#endif // IPC_RING_QUEUE_H_
@@ -0,0 +1,96 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef IPC_SPSC_QUEUE_H_
+#define IPC_SPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace oid
+{
+
+/**
+ * Bounded, lock-free queue for exactly one producer thread and one consumer
+ * thread. Neither side ever blocks: try_push fails when the queue is full and
+ * try_pop returns nothing when it is empty.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+
+  public:
+    /**
+     * Producer side. The value is only moved from if the push succeeds.
+     */
+    [[nodiscard]] bool try_push(T&& value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        slots_[tail & (Capacity - 1)] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Consumer side
+     */
+    [[nodiscard]] std::optional<T> try_pop()
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        // Leave a default constructed value behind, so that resources held by
+        // the element are released by the consumer
+        auto value = std::exchange(slots_[head & (Capacity - 1)], T{});
+        head_.store(head + 1, std::memory_order_release);
+
+        return value;
+    }
+
+  private:
+    // Keep both indices on separate cache lines to avoid false sharing
+    static constexpr std::size_t cache_line_size = 64;
+
+    alignas(cache_line_size) std::atomic<std::size_t> head_{0};
+    alignas(cache_line_size) std::atomic<std::size_t> tail_{0};
+
+    std::array<T, Capacity> slots_{};
+};
+
+} // namespace oid
+
+#endif // IPC_SPSC_QUEUE_H_
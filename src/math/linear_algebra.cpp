@@ -25,6 +25,7 @@
 
 #include "linear_algebra.h"
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -32,7 +33,7 @@ namespace oid
 {
 
 
-vec4::vec4(const float x, const float y, const float z, const float w)
+vec4::vec4(const double x, const double y, const double z, const double w)
     : vec_{x, y, z, w}
 {
 }
@@ -53,55 +54,55 @@ void vec4::print() const
 }
 
 
-float* vec4::data()
+double* vec4::data()
 {
     return vec_.data();
 }
 
 
-float& vec4::x()
+double& vec4::x()
 {
     return vec_[0];
 }
 
 
-float& vec4::y()
+double& vec4::y()
 {
     return vec_[1];
 }
 
 
-float& vec4::z()
+double& vec4::z()
 {
     return vec_[2];
 }
 
 
-float& vec4::w()
+double& vec4::w()
 {
     return vec_[3];
 }
 
 
-const float& vec4::x() const
+const double& vec4::x() const
 {
     return vec_[0];
 }
 
 
-const float& vec4::y() const
+const double& vec4::y() const
 {
     return vec_[1];
 }
 
 
-const float& vec4::z() const
+const double& vec4::z() const
 {
     return vec_[2];
 }
 
 
-const float& vec4::w() const
+const double& vec4::w() const
 {
     return vec_[3];
 }
@@ -109,7 +110,7 @@ const float& vec4::w() const
 
 vec4 vec4::zero()
 {
-    return {0.0f, 0.0f, 0.0f, 0.0f};
+    return {0.0, 0.0, 0.0, 0.0};
 }
 
 
@@ -132,14 +133,14 @@ void mat4::set_identity()
 }
 
 
-void mat4::set_from_st(const float scaleX,
-                       const float scaleY,
-                       const float scaleZ,
-                       const float x,
-                       const float y,
-                       const float z)
+void mat4::set_from_st(const double scaleX,
+                       const double scaleY,
+                       const double scaleZ,
+                       const double x,
+                       const double y,
+                       const double z)
 {
-    float* data = this->data();
+    double* data = this->data();
 
     data[0]  = scaleX;
     data[5]  = scaleY;
@@ -148,54 +149,63 @@ void mat4::set_from_st(const float scaleX,
     data[13] = y;
     data[14] = z;
 
-    data[1] = data[2] = data[3] = data[4] = 0.0f;
-    data[6] = data[7] = data[8] = data[9] = 0.0f;
-    data[11]                              = 0.0f;
-    data[15]                              = 1.0f;
+    data[1] = data[2] = data[3] = data[4] = 0.0;
+    data[6] = data[7] = data[8] = data[9] = 0.0;
+    data[11]                              = 0.0;
+    data[15]                              = 1.0;
 }
 
 
-void mat4::set_from_srt(const float scaleX,
-                        const float scaleY,
-                        const float scaleZ,
-                        const float rZ,
-                        const float x,
-                        const float y,
-                        const float z)
+void mat4::set_from_srt(const double scaleX,
+                        const double scaleY,
+                        const double scaleZ,
+                        const double rZ,
+                        const double x,
+                        const double y,
+                        const double z)
 {
-    using Eigen::Affine3f;
-    using Eigen::AngleAxisf;
-    using Eigen::Vector3f;
-
-    auto t = Affine3f::Identity();
-    t.translate(Vector3f(x, y, z))
-        .rotate(AngleAxisf(rZ, Vector3f(0.0f, 0.0f, 1.0f)))
-        .scale(Vector3f(scaleX, scaleY, scaleZ));
+    using Eigen::Affine3d;
+    using Eigen::AngleAxisd;
+    using Eigen::Vector3d;
+
+    auto t = Affine3d::Identity();
+    t.translate(Vector3d(x, y, z))
+        .rotate(AngleAxisd(rZ, Vector3d(0.0, 0.0, 1.0)))
+        .scale(Vector3d(scaleX, scaleY, scaleZ));
     this->mat_ = t.matrix();
 }
 
 
-float* mat4::data()
+double* mat4::data()
 {
     return mat_.data();
 }
 
 
+std::array<float, 16> mat4::to_float() const
+{
+    auto result = std::array<float, 16>{};
+    Eigen::Map<Eigen::Matrix4f>{result.data()} = mat_.cast<float>();
+
+    return result;
+}
+
+
 void mat4::operator<<(const std::initializer_list<float>& data)
 {
-    memcpy(mat_.data(), data.begin(), sizeof(float) * data.size());
+    std::copy(data.begin(), data.end(), mat_.data());
 }
 
 
-mat4 mat4::rotation(const float angle)
+mat4 mat4::rotation(const double angle)
 {
-    using Eigen::Affine3f;
-    using Eigen::AngleAxisf;
-    using Eigen::Vector3f;
+    using Eigen::Affine3d;
+    using Eigen::AngleAxisd;
+    using Eigen::Vector3d;
 
     auto result = mat4{};
-    auto t      = Affine3f::Identity();
-    t.rotate(AngleAxisf(angle, Vector3f(0.0f, 0.0f, 1.0f)));
+    auto t      = Affine3d::Identity();
+    t.rotate(AngleAxisd(angle, Vector3d(0.0, 0.0, 1.0)));
 
     result.mat_ = t.matrix();
     return result;
@@ -204,13 +214,13 @@ mat4 mat4::rotation(const float angle)
 
 mat4 mat4::translation(const vec4& vector)
 {
-    using Eigen::Affine3f;
-    using Eigen::Vector3f;
+    using Eigen::Affine3d;
+    using Eigen::Vector3d;
 
     auto result = mat4{};
 
-    auto t = Affine3f::Identity();
-    t.translate(Vector3f(vector.x(), vector.y(), vector.z()));
+    auto t = Affine3d::Identity();
+    t.translate(Vector3d(vector.x(), vector.y(), vector.z()));
     result.mat_ = t.matrix();
 
     return result;
@@ -219,35 +229,35 @@ mat4 mat4::translation(const vec4& vector)
 
 mat4 mat4::scale(const vec4& factor)
 {
-    using Eigen::Affine3f;
-    using Eigen::Vector3f;
+    using Eigen::Affine3d;
+    using Eigen::Vector3d;
 
     auto result = mat4{};
 
-    auto t = Affine3f::Identity();
-    t.scale(Vector3f(factor.x(), factor.y(), factor.z()));
+    auto t = Affine3d::Identity();
+    t.scale(Vector3d(factor.x(), factor.y(), factor.z()));
     result.mat_ = t.matrix();
 
     return result;
 }
 
 
-void mat4::set_ortho_projection(const float right,
-                                const float top,
-                                const float near,
-                                const float far)
+void mat4::set_ortho_projection(const double right,
+                                const double top,
+                                const double near,
+                                const double far)
 {
     const auto data = this->data();
 
-    data[0]  = 1.0f / right;
-    data[5]  = -1.0f / top;
-    data[10] = -2.0f / (far - near);
+    data[0]  = 1.0 / right;
+    data[5]  = -1.0 / top;
+    data[10] = -2.0 / (far - near);
     data[14] = -(far + near) / (far - near);
 
-    data[1] = data[2] = data[3] = data[4] = 0.0f;
-    data[6] = data[7] = data[8] = data[9] = 0.0f;
-    data[11] = data[12] = data[13] = 0.0f;
-    data[15]                       = 1.0f;
+    data[1] = data[2] = data[3] = data[4] = 0.0;
+    data[6] = data[7] = data[8] = data[9] = 0.0;
+    data[11] = data[12] = data[13] = 0.0;
+    data[15]                       = 1.0;
 }
 
 
@@ -266,7 +276,7 @@ mat4 mat4::inv() const
 }
 
 
-float& mat4::operator()(const int row, const int col)
+double& mat4::operator()(const int row, const int col)
 {
     return mat_(row, col);
 }
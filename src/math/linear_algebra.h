@@ -26,6 +26,8 @@
 #ifndef LINEAR_ALGEBRA_H_
 #define LINEAR_ALGEBRA_H_
 
+#include <array>
+
 #include <Eigen>
 
 namespace oid
@@ -40,7 +42,7 @@ class vec4
   public:
     vec4() = default;
 
-    vec4(float x, float y, float z, float w);
+    vec4(double x, double y, double z, double w);
 
     vec4& operator+=(const vec4& b);
 
@@ -60,7 +62,7 @@ class vec4
                 a.vec_[3] - b.vec_[3]};
     }
 
-    friend vec4 operator*(const vec4& vec, const float scalar)
+    friend vec4 operator*(const vec4& vec, const double scalar)
     {
         auto result = vec4{vec};
         result.vec_ *= scalar;
@@ -70,52 +72,64 @@ class vec4
 
     void print() const;
 
-    float* data();
+    double* data();
 
-    float& x();
-    float& y();
-    float& z();
-    float& w();
+    double& x();
+    double& y();
+    double& z();
+    double& w();
 
-    [[nodiscard]] const float& x() const;
-    [[nodiscard]] const float& y() const;
-    [[nodiscard]] const float& z() const;
-    [[nodiscard]] const float& w() const;
+    [[nodiscard]] const double& x() const;
+    [[nodiscard]] const double& y() const;
+    [[nodiscard]] const double& z() const;
+    [[nodiscard]] const double& w() const;
 
     static vec4 zero();
 
   private:
-    Eigen::Vector4f vec_{};
+    Eigen::Vector4d vec_{};
 };
 
 vec4 operator-(const vec4& vector);
 
 
+/**
+ * Transforms are composed in double precision, so that positions within
+ * buffers wider than 2^24 pixels remain exact. They are only converted to
+ * single precision once handed over to OpenGL.
+ */
 class mat4
 {
   public:
     void set_identity();
 
-    void set_from_srt(float scaleX,
-                      float scaleY,
-                      float scaleZ,
-                      float rZ,
-                      float x,
-                      float y,
-                      float z);
-
-    void set_from_st(float scaleX,
-                     float scaleY,
-                     float scaleZ,
-                     float x,
-                     float y,
-                     float z);
-
-    float* data();
+    void set_from_srt(double scaleX,
+                      double scaleY,
+                      double scaleZ,
+                      double rZ,
+                      double x,
+                      double y,
+                      double z);
+
+    void set_from_st(double scaleX,
+                     double scaleY,
+                     double scaleZ,
+                     double x,
+                     double y,
+                     double z);
+
+    double* data();
+
+    /**
+     * Column major elements in single precision, as expected by
+     * glUniformMatrix4fv
+     */
+    [[nodiscard]] std::array<float, 16> to_float() const;
 
     void operator<<(const std::initializer_list<float>& data);
 
-    void set_ortho_projection(float right, float top, float near, float far);
+    void
+    set_ortho_projection(double right, double top, double near, double far);
 
     void print() const;
 
@@ -132,16 +146,16 @@ class mat4
 
     vec4 operator*(const vec4& vec) const;
 
-    float& operator()(int row, int col);
+    double& operator()(int row, int col);
 
-    static mat4 rotation(float angle);
+    static mat4 rotation(double angle);
 
     static mat4 translation(const vec4& vector);
 
     static mat4 scale(const vec4& factor);
 
   private:
-    Eigen::Matrix4f mat_{};
+    Eigen::Matrix4d mat_{};
 };
 
 } // namespace oid
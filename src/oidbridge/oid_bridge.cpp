@@ -26,40 +26,121 @@
 #include "oid_bridge.h"
 
 #include <cstdint>
+#include <cstring>
 
-#include <bit>
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "debuggerinterface/preprocessor_directives.h"
 #include "debuggerinterface/python_native_interface.h"
+#include "ipc/buffer_preview.h"
+#include "ipc/buffer_tiles.h"
 #include "ipc/message_exchange.h"
+#include "ipc/ring_queue.h"
+#include "sender_thread.h"
+#include "system/event_notifier/event_notifier.h"
+#include "system/inferior_memory/inferior_memory.h"
 #include "system/process/process.h"
+#include "system/shared_memory/shared_memory.h"
 
 #include <QDataStream>
 #include <QTcpServer>
 #include <QTcpSocket>
 
+#if defined(Q_OS_UNIX)
+#include <sys/socket.h>
+#endif
+
 
 using namespace oid;
 
-struct UiMessage
+struct GetObservedSymbolsResponseMessage
 {
-    virtual ~UiMessage() = default;
+    std::deque<std::string> observed_symbols{};
 };
 
-struct GetObservedSymbolsResponseMessage final : UiMessage
+struct PlotBufferRequestMessage
 {
-    std::deque<std::string> observed_symbols{};
+    std::string buffer_name{};
 };
 
-struct PlotBufferRequestMessage final : UiMessage
+struct PlotBufferBatchRequestMessage
+{
+    std::deque<std::string> buffer_names{};
+};
+
+struct AvailableSymbolsRequestMessage
+{
+};
+
+struct PlotBufferRegionRequestMessage
 {
     std::string buffer_name{};
+    BufferRegion region{};
+};
+
+// Requests sent by the window, to be handled by the event loop in the order
+// they arrived
+using UiRequest = std::variant<std::monostate,
+                               PlotBufferRequestMessage,
+                               PlotBufferBatchRequestMessage,
+                               AvailableSymbolsRequestMessage,
+                               PlotBufferRegionRequestMessage>;
+
+/**
+ * Buffer contents read by the bridge straight from the debugged process
+ */
+struct InferiorPayload
+{
+    std::unique_ptr<uint8_t[]> contents{};
+
+    // Large payloads are read into the segment they are sent in instead
+    std::optional<SharedMemory> segment{};
+};
+
+/**
+ * Buffer given to oid_plot_buffer, which is sent to the window asynchronously
+ */
+struct PlotRequest
+{
+    BufferMetadata metadata{};
+    const uint8_t* buff_ptr{};
+    std::size_t buff_size{};
+    int preview_downsampling{1};
+
+    // If set, buff_ptr only holds the sampled rows of this region
+    std::optional<BufferRegion> region{};
+
+    // Object that owns buff_ptr, referenced until the buffer is sent. Null if
+    // the contents are read from the debugged process by the bridge.
+    PyObject* payload_owner{};
+
+    std::int64_t inferior_pid{};
+    std::uint64_t inferior_address{};
+    std::shared_ptr<const InferiorPayload> inferior_payload{};
+
+    // Set if the buffer was not written since it was last read from the
+    // debugged process, in which case it is neither read nor sent again
+    bool is_unchanged{};
+
+    // Order in which whole buffers were queued, so that the ones superseded
+    // by a newer plot of the same symbol are not sent. Zero for plots that
+    // cannot be superseded.
+    std::uint64_t sequence{};
 };
 
 class PyGILRAII
@@ -85,6 +166,25 @@ class PyGILRAII
     PyGILState_STATE _py_gil_state{};
 };
 
+/**
+ * Make a call that may block, releasing the GIL meanwhile if the calling
+ * thread holds it. The call must not touch any Python object.
+ */
+template <typename Call>
+void call_without_gil(Call&& call)
+{
+    if (PyGILState_Check() == 0) {
+        call();
+        return;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+
+    call();
+
+    Py_END_ALLOW_THREADS
+}
+
 class OidBridge
 {
   public:
@@ -115,6 +215,21 @@ class OidBridge
 
         wait_for_client();
 
+        // The window announces its capabilities as soon as it connects
+        if (client_ != nullptr) {
+            try_read_incoming_messages();
+
+#if defined(Q_OS_UNIX)
+            // Payloads are written straight to the socket descriptor, which
+            // is safe while Qt reads from it on the debugger thread. The
+            // socket object is never touched by the sender thread, so its
+            // descriptor is captured here. Other platforms go through the
+            // socket object, so they send in place.
+            client_descriptor_ = static_cast<int>(client_->socketDescriptor());
+            sender_.emplace(max_queued_jobs);
+#endif
+        }
+
         return client_ != nullptr;
     }
 
@@ -123,180 +238,1141 @@ class OidBridge
         oid_path_ = oid_path;
     }
 
-    [[nodiscard]] bool is_window_ready() const
-    {
-        return client_ != nullptr && ui_proc_.isRunning();
-    }
+    void set_shared_memory_enabled(const bool is_enabled)
+    {
+        use_shared_memory_ = is_enabled;
+    }
+
+    void set_compression_enabled(const bool is_enabled)
+    {
+        use_compression_ = is_enabled;
+    }
+
+    void set_region_callback(PyObject* region_callback)
+    {
+        Py_XINCREF(region_callback);
+        Py_XDECREF(region_callback_);
+        region_callback_ = region_callback;
+    }
+
+    void set_plot_buffers_callback(PyObject* plot_buffers_callback)
+    {
+        Py_XINCREF(plot_buffers_callback);
+        Py_XDECREF(plot_buffers_callback_);
+        plot_buffers_callback_ = plot_buffers_callback;
+    }
+
+    void set_symbols_callback(PyObject* symbols_callback)
+    {
+        Py_XINCREF(symbols_callback);
+        Py_XDECREF(symbols_callback_);
+        symbols_callback_ = symbols_callback;
+    }
+
+    /**
+     * A window whose connection was cut short by a partly written frame is
+     * never ready again, so that a new one is started instead
+     */
+    [[nodiscard]] bool is_window_ready()
+    {
+        if (is_connection_broken_ && client_ != nullptr &&
+            client_->state() != QAbstractSocket::UnconnectedState) {
+            client_->abort();
+        }
+
+        return client_ != nullptr && !is_connection_broken_ &&
+               ui_proc_.isRunning();
+    }
+
+    std::deque<std::string> get_observed_symbols()
+    {
+        assert(client_ != nullptr);
+
+        // The response is only waited for once the request went out, which
+        // happens after the plots queued before it were sent
+        auto request_sent    = std::make_shared<std::promise<void>>();
+        auto is_request_sent = request_sent->get_future();
+        post([this, request_sent] {
+            auto message_composer = MessageComposer{};
+            send(message_composer.push(MessageType::GetObservedSymbols));
+            request_sent->set_value();
+        });
+        call_without_gil([&] { is_request_sent.wait(); });
+
+        if (auto response = fetch_observed_symbols_response();
+            response.has_value()) {
+            auto observed_symbols = std::move(response->observed_symbols);
+
+            // Drop tile hashes of buffers the window stopped displaying
+            std::erase_if(inferior_snapshots_, [&](const auto& snapshot) {
+                return std::ranges::find(observed_symbols, snapshot.first) ==
+                       observed_symbols.end();
+            });
+            post([this, observed_symbols] {
+                std::erase_if(sent_buffers_, [&](const auto& sent_buffer) {
+                    return std::ranges::find(observed_symbols,
+                                             sent_buffer.first) ==
+                           observed_symbols.end();
+                });
+            });
+
+            return observed_symbols;
+        }
+
+        return {};
+    }
+
+
+    void set_available_symbols(const std::deque<std::string>& available_vars)
+    {
+        assert(client_ != nullptr);
+
+        auto message_composer = MessageComposer{};
+        message_composer.push(MessageType::SetAvailableSymbols)
+            .push(available_vars);
+        post_message(std::move(message_composer));
+    }
+
+    void update_available_symbols(const std::deque<std::string>& added_vars,
+                                  const std::deque<std::string>& removed_vars)
+    {
+        assert(client_ != nullptr);
+
+        auto message_composer = MessageComposer{};
+        message_composer.push(MessageType::UpdateAvailableSymbols)
+            .push(added_vars)
+            .push(removed_vars);
+        post_message(std::move(message_composer));
+    }
+
+    /**
+     * Descriptors that become readable when the window sent messages that
+     * run_event_loop() should handle: the socket, and a notifier for messages
+     * that were already received while waiting for a response
+     *
+     * @return the descriptors, or none if they cannot be waited upon on this
+     *     platform, in which case run_event_loop() must be polled
+     */
+    [[nodiscard]] std::vector<int> get_event_descriptors() const
+    {
+        if (client_ == nullptr || pending_messages_notifier_.descriptor() < 0) {
+            return {};
+        }
+
+        return {static_cast<int>(client_->socketDescriptor()),
+                pending_messages_notifier_.descriptor()};
+    }
+
+    void run_event_loop()
+    {
+        release_sent_payloads();
+
+        // Messages that already arrived are handled without waiting for more,
+        // since the debugger waits on the event descriptors between calls
+        try_read_incoming_messages(0);
+
+        // All pending requests are handled in one pass. Buffers are plotted
+        // in the order they were requested, batches are merged and only the
+        // latest region is requested, since it reflects what the window
+        // currently displays.
+        auto batch_request  = PlotBufferBatchRequestMessage{};
+        auto region_request = std::optional<PlotBufferRegionRequestMessage>{};
+        auto is_symbol_request = false;
+
+        while (auto request = received_requests_.try_pop()) {
+            if (const auto* plot =
+                    std::get_if<PlotBufferRequestMessage>(&*request)) {
+                request_buffer(*plot);
+            } else if (auto* batch = std::get_if<PlotBufferBatchRequestMessage>(
+                           &*request)) {
+                std::ranges::move(
+                    batch->buffer_names,
+                    std::back_inserter(batch_request.buffer_names));
+            } else if (std::holds_alternative<AvailableSymbolsRequestMessage>(
+                           *request)) {
+                is_symbol_request = true;
+            } else if (auto* region =
+                           std::get_if<PlotBufferRegionRequestMessage>(
+                               &*request)) {
+                region_request = std::move(*region);
+            }
+        }
+
+        if (!batch_request.buffer_names.empty()) {
+            request_buffer_batch(batch_request);
+        }
+
+        if (is_symbol_request) {
+            request_available_symbols();
+        }
+
+        if (region_request.has_value()) {
+            request_buffer_region(*region_request);
+        }
+
+        pending_messages_notifier_.clear();
+    }
+
+    /**
+     * Queue a buffer to be sent by the sender thread. The payload owner, which
+     * must have been referenced by the caller, is released on the debugger
+     * thread once the buffer was sent. May be called without holding the GIL.
+     */
+    void plot_buffer(PlotRequest&& request)
+    {
+        post_plots({std::move(request)}, [this](const auto& batch) {
+            send_plot(*batch.front(), batch.front()->preview_downsampling);
+        });
+    }
+
+    /**
+     * Queue buffers that the window displays together. Previews are not sent,
+     * since the whole batch is displayed at once. The first buffer may be
+     * sent in a batch of its own, ahead of the others, so that it is
+     * displayed sooner.
+     */
+    void plot_buffers(std::vector<PlotRequest>&& requests,
+                      const bool is_first_sent_apart)
+    {
+        if (is_first_sent_apart && requests.size() > 1) {
+            auto others = std::vector<PlotRequest>(
+                std::make_move_iterator(std::next(requests.begin())),
+                std::make_move_iterator(requests.end()));
+            requests.resize(1);
+            plot_buffers(std::move(requests), false);
+            plot_buffers(std::move(others), false);
+            return;
+        }
+
+        post_plots(std::move(requests), [this](const auto& batch) {
+            // Each request is sent as exactly one frame
+            auto message_composer = MessageComposer{};
+            send(message_composer.push(MessageType::PlotBufferBatch)
+                     .push(batch.size()));
+
+            for (const auto* request : batch) {
+                send_plot(*request, 1);
+            }
+        });
+    }
+
+    /**
+     * Read the contents of the plot requests that only hold the address of
+     * their buffer in the debugged process. Buffers whose pages were not
+     * written since they were last read are marked as unchanged instead. Must
+     * be called while the process is stopped, and may be called without
+     * holding the GIL.
+     *
+     * @return number of requests that could not be read, which are removed
+     */
+    std::size_t read_inferior_payloads(std::vector<PlotRequest>& requests)
+    {
+        auto read_snapshots =
+            std::vector<std::pair<std::string, InferiorSnapshot>>{};
+
+        const auto is_unread = [&](PlotRequest& request) {
+            const auto& name = request.metadata.variable_name;
+            if (request.payload_owner != nullptr ||
+                request.region.has_value()) {
+                // The window will hold something else than the last read
+                inferior_snapshots_.erase(name);
+                return request.payload_owner == nullptr &&
+                       !read_inferior_payload(request);
+            }
+
+            // The layout is captured before rows are packed by the read
+            auto snapshot = InferiorSnapshot{.pid = request.inferior_pid,
+                                             .address =
+                                                 request.inferior_address,
+                                             .metadata = request.metadata,
+                                             .length   = request.buff_size};
+
+            request.is_unchanged = is_inferior_buffer_unchanged(snapshot);
+            if (!request.is_unchanged && !read_inferior_payload(request)) {
+                inferior_snapshots_.erase(name);
+                return true;
+            }
+
+            read_snapshots.emplace_back(name, std::move(snapshot));
+            return false;
+        };
+
+        const auto unread = std::ranges::remove_if(requests, is_unread);
+
+        const auto unread_count = static_cast<std::size_t>(unread.size());
+        requests.erase(unread.begin(), unread.end());
+
+        if (read_snapshots.empty()) {
+            return unread_count;
+        }
+
+        // Pages written from now on mark the buffers read above as changed.
+        // Tracking restarts for the whole process, so the snapshots of
+        // buffers that were not read this time are only carried over if their
+        // pages were not written until now.
+        const auto pid = read_snapshots.front().second.pid;
+        std::erase_if(inferior_snapshots_, [&](const auto& entry) {
+            const auto& snapshot = entry.second;
+            return snapshot.epoch != written_pages_epoch_ ||
+                   snapshot.pid != pid ||
+                   was_inferior_memory_written(
+                       pid, {snapshot.address, snapshot.length});
+        });
+
+        if (!clear_inferior_written_pages(pid)) {
+            inferior_snapshots_.clear();
+            return unread_count;
+        }
+
+        ++written_pages_epoch_;
+        for (auto& [name, snapshot] : inferior_snapshots_) {
+            snapshot.epoch = written_pages_epoch_;
+        }
+        for (auto& [name, snapshot] : read_snapshots) {
+            snapshot.epoch = snapshot.pid == pid ? written_pages_epoch_ : 0;
+            inferior_snapshots_.insert_or_assign(name, std::move(snapshot));
+        }
+
+        return unread_count;
+    }
+
+    /**
+     * Read the contents of a plot request that only holds the address of its
+     * buffer in the debugged process
+     *
+     * @return false if the memory could not be read
+     */
+    [[nodiscard]] bool read_inferior_payload(PlotRequest& request) const
+    {
+        const auto& metadata = request.metadata;
+        const auto pixel_size =
+            type_size(metadata.type) * static_cast<size_t>(metadata.channels);
+
+        // Regions are read one sampled row at a time, skipping the columns
+        // around them
+        auto ranges = std::vector<InferiorMemoryRange>{};
+        if (const auto& region = request.region; region.has_value()) {
+            const auto row_stride =
+                static_cast<std::uint64_t>(metadata.stride) * pixel_size;
+            const auto row_length =
+                static_cast<std::size_t>(region->width) * pixel_size;
+            for (auto y = region->y; y < region->y + region->height;
+                 y += region->downsampling) {
+                ranges.push_back(
+                    {request.inferior_address +
+                         static_cast<std::uint64_t>(y) * row_stride +
+                         static_cast<std::uint64_t>(region->x) * pixel_size,
+                     row_length});
+            }
+        } else if (metadata.stride > metadata.width) {
+            // Rows are gathered without their padding, so that views into
+            // larger images only transfer the pixels they show
+            const auto row_stride =
+                static_cast<std::uint64_t>(metadata.stride) * pixel_size;
+            const auto row_length =
+                static_cast<std::size_t>(metadata.width) * pixel_size;
+            for (std::int64_t y = 0; y < metadata.height; ++y) {
+                const auto row_offset =
+                    static_cast<std::uint64_t>(y) * row_stride;
+                ranges.push_back(
+                    {request.inferior_address + row_offset, row_length});
+            }
+
+            request.metadata.stride = metadata.width;
+            request.buff_size =
+                row_length * static_cast<std::size_t>(metadata.height);
+        } else {
+            ranges.push_back({request.inferior_address, request.buff_size});
+        }
+
+        auto payload     = std::make_shared<InferiorPayload>();
+        auto destination = static_cast<uint8_t*>(nullptr);
+        if (!request.region.has_value() && use_shared_memory_ &&
+            request.buff_size >= shared_memory_threshold &&
+            request.buff_size <= max_tracked_shared_bytes) {
+            if (auto segment = SharedMemory{};
+                segment.create(request.buff_size)) {
+                destination = segment.data();
+                payload->segment.emplace(std::move(segment));
+            }
+        }
+        if (destination == nullptr) {
+            payload->contents =
+                std::make_unique_for_overwrite<uint8_t[]>(request.buff_size);
+            destination = payload->contents.get();
+        }
+
+        if (!read_inferior_memory(
+                request.inferior_pid, ranges, destination)) {
+            if (payload->segment.has_value()) {
+                payload->segment->unlink();
+            }
+            return false;
+        }
+
+        request.buff_ptr         = destination;
+        request.inferior_payload = std::move(payload);
+
+        return true;
+    }
+
+    /**
+     * Check whether the memory of a debugged process can be read directly.
+     * The result is remembered for each process.
+     */
+    [[nodiscard]] bool can_read_inferior_memory(const std::int64_t pid,
+                                                const std::uint64_t address)
+    {
+        if (const auto support = inferior_read_support_.find(pid);
+            support != inferior_read_support_.end()) {
+            return support->second;
+        }
+
+        auto probe = uint8_t{};
+        const auto is_supported =
+            read_inferior_memory(pid, {{address, sizeof(probe)}}, &probe);
+        inferior_read_support_.emplace(pid, is_supported);
+
+        return is_supported;
+    }
+
+    /**
+     * @return number of plots that were queued and not entirely sent yet
+     */
+    [[nodiscard]] int get_pending_plots() const
+    {
+        return pending_plots_;
+    }
+
+    /**
+     * Release the payload objects of plots that were sent. Requires the GIL.
+     */
+    void release_sent_payloads()
+    {
+        auto sent_payloads = std::vector<PyObject*>{};
+        {
+            const auto lock = std::scoped_lock{sent_payloads_mutex_};
+            sent_payloads.swap(sent_payloads_);
+        }
+
+        for (const auto payload : sent_payloads) {
+            Py_DECREF(payload);
+        }
+    }
+
+    ~OidBridge()
+    {
+        ui_proc_.kill();
+
+        // Queued plots are still run, so that their payloads are released
+        sender_.reset();
+        release_sent_payloads();
+
+        Py_XDECREF(region_callback_);
+        Py_XDECREF(plot_buffers_callback_);
+        Py_XDECREF(symbols_callback_);
+
+        // Segments are unlinked by the window as soon as they are mapped;
+        // remove the ones it did not get to consume
+        for (const auto& segment : shared_segments_) {
+            SharedMemory::remove(segment.name);
+        }
+    }
+
+  private:
+    static constexpr std::size_t shared_memory_threshold  = 1 << 20;
+    static constexpr std::size_t max_tracked_shared_bytes = 1 << 30;
+    static constexpr std::size_t compression_threshold    = 64 << 10;
+    static constexpr std::size_t max_queued_jobs          = 4;
+
+    Process ui_proc_{};
+    QTcpServer server_{};
+    QTcpSocket* client_{nullptr};
+
+    // Native descriptor of client_, which the sender thread writes to
+    int client_descriptor_{-1};
+
+    // Set once a frame could not be written whole
+    std::atomic<bool> is_connection_broken_{false};
+    FrameAssembler frame_assembler_{};
+    std::string oid_path_{};
+
+    bool use_shared_memory_{true};
+
+    // Segments handed over to the window, oldest first, and their total size
+    struct SharedSegment
+    {
+        std::string name{};
+        std::size_t size{};
+    };
+    std::deque<SharedSegment> shared_segments_{};
+    std::size_t shared_segments_size_{0};
+
+    bool use_compression_{true};
+    std::atomic<PayloadCodec> payload_codec_{PayloadCodec::None};
+
+    // Tile hashes of the last payload sent for each symbol. Only accessed by
+    // jobs of the sender thread.
+    struct SentBuffer
+    {
+        BufferMetadata metadata{};
+        std::size_t length{};
+        std::vector<std::uint64_t> tile_hashes{};
+    };
+    std::map<std::string, SentBuffer, std::less<>> sent_buffers_{};
+
+    int (*plot_callback_)(const char*){};
+    PyObject* region_callback_{nullptr};
+    PyObject* plot_buffers_callback_{nullptr};
+    PyObject* symbols_callback_{nullptr};
+
+    RingQueue<UiRequest> received_requests_{};
+    std::optional<GetObservedSymbolsResponseMessage>
+        observed_symbols_response_{};
+
+    // Notified while received_requests_ holds requests to be handled by
+    // run_event_loop()
+    EventNotifier pending_messages_notifier_{};
+
+    std::atomic<int> pending_plots_{0};
+    std::mutex sent_payloads_mutex_{};
+    std::vector<PyObject*> sent_payloads_{};
+
+    std::optional<SenderThread> sender_{};
+
+    // Sequence of the newest queued plot of each symbol
+    std::mutex latest_plots_mutex_{};
+    std::map<std::string, std::uint64_t, std::less<>> latest_plots_{};
+    std::uint64_t plot_sequence_{0};
+
+    std::map<std::int64_t, bool> inferior_read_support_{};
+
+    // Buffers that were last read from the debugged process by the bridge,
+    // along with the write tracking epoch that started right after they were
+    // read. Only accessed by the debugger thread.
+    struct InferiorSnapshot
+    {
+        std::int64_t pid{};
+        std::uint64_t address{};
+        BufferMetadata metadata{};
+        std::size_t length{};
+        std::uint64_t epoch{};
+    };
+    std::map<std::string, InferiorSnapshot, std::less<>> inferior_snapshots_{};
+    std::uint64_t written_pages_epoch_{0};
+
+    /**
+     * Check whether the window already holds the contents of a buffer, since
+     * its memory was not written after it was last read
+     */
+    [[nodiscard]] bool
+    is_inferior_buffer_unchanged(const InferiorSnapshot& current) const
+    {
+        const auto snapshot =
+            inferior_snapshots_.find(current.metadata.variable_name);
+        if (snapshot == inferior_snapshots_.end()) {
+            return false;
+        }
+
+        const auto& previous = snapshot->second;
+        return previous.epoch == written_pages_epoch_ &&
+               previous.pid == current.pid &&
+               previous.address == current.address &&
+               previous.metadata == current.metadata &&
+               previous.length == current.length &&
+               !was_inferior_memory_written(
+                   current.pid, {current.address, current.length});
+    }
+
+    /**
+     * Run a job on the sender thread, or in place if there is none. Jobs never
+     * touch Python objects, so the GIL is released while the queue is full.
+     */
+    void post(SenderThread::Job&& job)
+    {
+        if (sender_.has_value()) {
+            call_without_gil([&] { sender_->enqueue(std::move(job)); });
+        } else {
+            job();
+        }
+    }
+
+    /**
+     * Send a message after the plots that were queued before it. Frames are
+     * only written by jobs, so that none gets in between those of a batch.
+     */
+    void post_message(MessageComposer&& message_composer)
+    {
+        post([this, message_composer = std::move(message_composer)] {
+            send(message_composer);
+        });
+    }
+
+    /**
+     * Queue plots to be sent by the sender thread. send_plots is only given
+     * the plots that were not superseded by the time they are sent, and is
+     * not called if there are none.
+     */
+    template <typename SendPlots>
+    void post_plots(std::vector<PlotRequest>&& requests, SendPlots&& send_plots)
+    {
+        pending_plots_ += static_cast<int>(requests.size());
+
+        // Whole buffers supersede the ones of the same symbol that are still
+        // queued. Regions are only requested for what the window displays,
+        // and unchanged buffers refer to contents queued before them, so
+        // neither takes part.
+        {
+            const auto lock = std::scoped_lock{latest_plots_mutex_};
+            for (auto& request : requests) {
+                if (!request.region.has_value() && !request.is_unchanged) {
+                    request.sequence = ++plot_sequence_;
+                    latest_plots_.insert_or_assign(
+                        request.metadata.variable_name, request.sequence);
+                }
+            }
+        }
+
+        // std::function must be copyable, so the requests are shared
+        auto shared_requests =
+            std::make_shared<const std::vector<PlotRequest>>(
+                std::move(requests));
+        post([this, shared_requests, send_plots] {
+            if (const auto latest_requests =
+                    take_latest_plots(*shared_requests);
+                !latest_requests.empty()) {
+                send_plots(latest_requests);
+            }
+
+            {
+                const auto lock = std::scoped_lock{sent_payloads_mutex_};
+                for (const auto& request : *shared_requests) {
+                    if (request.payload_owner != nullptr) {
+                        sent_payloads_.push_back(request.payload_owner);
+                    }
+                }
+            }
+            pending_plots_ -= static_cast<int>(shared_requests->size());
+        });
+    }
+
+    /**
+     * Filter out the plots superseded by a newer plot of the same symbol.
+     * The remaining ones are about to be sent, so they are forgotten.
+     */
+    std::vector<const PlotRequest*>
+    take_latest_plots(const std::vector<PlotRequest>& requests)
+    {
+        const auto lock = std::scoped_lock{latest_plots_mutex_};
+
+        auto latest_requests = std::vector<const PlotRequest*>{};
+        for (const auto& request : requests) {
+            if (request.sequence == 0) {
+                latest_requests.push_back(&request);
+                continue;
+            }
+
+            if (const auto latest =
+                    latest_plots_.find(request.metadata.variable_name);
+                latest != latest_plots_.end() &&
+                latest->second == request.sequence) {
+                latest_plots_.erase(latest);
+                latest_requests.push_back(&request);
+            }
+        }
+
+        return latest_requests;
+    }
+
+    void send_plot(const PlotRequest& request, const int preview_downsampling)
+    {
+        if (request.is_unchanged) {
+            auto message_composer = MessageComposer{};
+            send(message_composer.push(MessageType::PlotBufferUnchanged)
+                     .push(request.metadata.variable_name));
+            return;
+        }
+
+        if (request.region.has_value()) {
+            send_buffer_region(
+                request.metadata, *request.region, request.buff_ptr);
+            return;
+        }
+
+        const auto& inferior_payload = request.inferior_payload;
+        send_buffer(request.metadata,
+                    request.buff_ptr,
+                    request.buff_size,
+                    preview_downsampling,
+                    inferior_payload != nullptr &&
+                            inferior_payload->segment.has_value()
+                        ? &*inferior_payload->segment
+                        : nullptr);
+    }
+
+    /**
+     * Write a frame to the window. Nothing is written once a frame could only
+     * be written in part, since the window could not tell where the next ones
+     * start: the connection is shut down instead, which closes the window.
+     */
+    void send(const MessageComposer& message_composer)
+    {
+        if (is_connection_broken_) {
+            return;
+        }
+
+#if defined(Q_OS_UNIX)
+        // The sender thread may only shut the descriptor down. The socket
+        // object is aborted on the debugger thread by is_window_ready(), which
+        // closes the descriptor, so the flag is only raised afterwards.
+        if (sender_.has_value()) {
+            if (!message_composer.send(client_descriptor_)) {
+                shutdown(client_descriptor_, SHUT_RDWR);
+                is_connection_broken_ = true;
+            }
+            return;
+        }
+#endif
+
+        if (!message_composer.send(client_)) {
+            is_connection_broken_ = true;
+            client_->abort();
+        }
+    }
+
+    /**
+     * @param written_segment segment that already holds the buffer, if any
+     */
+    void send_buffer(const BufferMetadata& metadata,
+                     const uint8_t* buff_ptr,
+                     const size_t buff_length,
+                     const int preview_downsampling,
+                     const SharedMemory* written_segment)
+    {
+        auto tile_hashes = hash_buffer_tiles(buff_ptr, buff_length);
+
+        // If the window holds a buffer with the same layout, only send the
+        // tiles that changed since it was last plotted
+        if (const auto sent_buffer = sent_buffers_.find(metadata.variable_name);
+            sent_buffer != sent_buffers_.end() &&
+            sent_buffer->second.metadata == metadata &&
+            sent_buffer->second.length == buff_length) {
+            const auto changed_tiles = find_changed_tiles(
+                sent_buffer->second.tile_hashes, tile_hashes, buff_length);
+
+            auto changed_bytes = std::size_t{0};
+            for (const auto& range : changed_tiles) {
+                changed_bytes += range.length;
+            }
+
+            if (changed_bytes <= buff_length / 2) {
+                send_buffer_tiles(
+                    metadata, buff_ptr, buff_length, changed_tiles);
+                sent_buffer->second.tile_hashes = std::move(tile_hashes);
+
+                if (written_segment != nullptr) {
+                    SharedMemory::remove(written_segment->name());
+                }
+                return;
+            }
+        }
+
+        // Give the window something to display while the full resolution
+        // contents are in flight
+        if (preview_downsampling > 1) {
+            send_buffer_preview(metadata, buff_ptr, preview_downsampling);
+        }
+
+        send_buffer_contents(metadata, buff_ptr, buff_length, written_segment);
+
+        sent_buffers_.insert_or_assign(
+            metadata.variable_name,
+            SentBuffer{metadata, buff_length, std::move(tile_hashes)});
+    }
+
+    void send_buffer_region(const BufferMetadata& metadata,
+                            const BufferRegion& region,
+                            const uint8_t* rows_ptr)
+    {
+        // Rows were sampled by the debugger, columns are sampled here
+        const auto pixel_size =
+            type_size(metadata.type) * static_cast<size_t>(metadata.channels);
+        const auto sampled =
+            sample_region_columns(rows_ptr, region, pixel_size);
+
+        auto message_composer = MessageComposer{};
+        send(message_composer.push(MessageType::PlotBufferRegion)
+                 .push(region)
+                 .push(metadata)
+                 .push(sampled.data(), sampled.size()));
+
+        // The window no longer holds the whole buffer
+        sent_buffers_.erase(metadata.variable_name);
+    }
+
+    void try_read_incoming_messages(const int msecs = 3000)
+    {
+        assert(client_ != nullptr);
+
+        // Wait for a complete message, then also handle the ones that arrived
+        // along with it
+        auto frame = MessageFrame{};
+        while (!frame_assembler_.receive(client_, frame)) {
+            if (!client_->waitForReadyRead(msecs)) {
+                return;
+            }
+        }
+
+        do {
+            auto header          = MessageType{};
+            auto message_decoder = MessageDecoder{frame};
+            message_decoder.read(header);
+
+            switch (header) {
+            case MessageType::PlotBufferRequest:
+                received_requests_.push(
+                    decode_plot_buffer_request(message_decoder));
+                break;
+            case MessageType::GetObservedSymbolsResponse:
+                observed_symbols_response_ =
+                    decode_get_observed_symbols_response(message_decoder);
+                break;
+            case MessageType::PlotBufferBatchRequest:
+                received_requests_.push(
+                    decode_plot_buffer_batch_request(message_decoder));
+                break;
+            case MessageType::AvailableSymbolsRequest:
+                received_requests_.push(AvailableSymbolsRequestMessage{});
+                break;
+            case MessageType::PlotBufferRegionRequest:
+                received_requests_.push(
+                    decode_plot_buffer_region_request(message_decoder));
+                break;
+            case MessageType::WindowCapabilities:
+                decode_window_capabilities(message_decoder);
+                break;
+            default:
+                std::cerr
+                    << "[OpenImageDebugger] Received message with incorrect "
+                       "header"
+                    << std::endl;
+                break;
+            }
+        } while (frame_assembler_.receive(client_, frame));
+
+        // Requests received while waiting for a response are no longer
+        // signaled by the socket
+        if (!received_requests_.empty()) {
+            pending_messages_notifier_.notify();
+        }
+    }
+
+
+    [[nodiscard]] static PlotBufferRequestMessage
+    decode_plot_buffer_request(MessageDecoder& message_decoder)
+    {
+        auto request = PlotBufferRequestMessage{};
+        message_decoder.read(request.buffer_name);
+        return request;
+    }
+
+    [[nodiscard]] static PlotBufferBatchRequestMessage
+    decode_plot_buffer_batch_request(MessageDecoder& message_decoder)
+    {
+        auto request = PlotBufferBatchRequestMessage{};
+        message_decoder.read<std::deque<std::string>, std::string>(
+            request.buffer_names);
+        return request;
+    }
+
+    [[nodiscard]] static PlotBufferRegionRequestMessage
+    decode_plot_buffer_region_request(MessageDecoder& message_decoder)
+    {
+        auto request = PlotBufferRegionRequestMessage{};
+        message_decoder.read(request.buffer_name).read(request.region);
+        return request;
+    }
+
+    [[nodiscard]] static GetObservedSymbolsResponseMessage
+    decode_get_observed_symbols_response(MessageDecoder& message_decoder)
+    {
+        auto response = GetObservedSymbolsResponseMessage{};
+
+        message_decoder.read<std::deque<std::string>, std::string>(
+            response.observed_symbols);
+
+        return response;
+    }
+
+    void decode_window_capabilities(MessageDecoder& message_decoder)
+    {
+        auto codec_count = std::size_t{};
+        message_decoder.read(codec_count);
+
+        for (std::size_t c = 0; c < codec_count && message_decoder.is_valid();
+             ++c) {
+            auto codec = PayloadCodec{};
+            message_decoder.read(codec);
+
+            if (codec == PayloadCodec::ShuffleLz) {
+                payload_codec_ = codec;
+            }
+        }
+    }
+
+    void request_buffer_region(const PlotBufferRegionRequestMessage& message)
+    {
+        if (region_callback_ == nullptr) {
+            return;
+        }
+
+        // Coordinates are 64-bit, so they are passed as long long
+        const auto& [x, y, width, height, downsampling] = message.region;
+        const auto result =
+            PyObject_CallFunction(region_callback_,
+                                  "sLLLLi",
+                                  message.buffer_name.c_str(),
+                                  static_cast<long long>(x),
+                                  static_cast<long long>(y),
+                                  static_cast<long long>(width),
+                                  static_cast<long long>(height),
+                                  downsampling);
+        if (result == nullptr) {
+            PyErr_Print();
+            return;
+        }
+
+        Py_DECREF(result);
+    }
+
+    void request_available_symbols() const
+    {
+        if (symbols_callback_ == nullptr) {
+            return;
+        }
+
+        const auto result =
+            PyObject_CallFunctionObjArgs(symbols_callback_, nullptr);
+        if (result == nullptr) {
+            PyErr_Print();
+            return;
+        }
+
+        Py_DECREF(result);
+    }
+
+    void request_buffer(const PlotBufferRequestMessage& message)
+    {
+        // The window may no longer hold this buffer, so the next plot must
+        // carry its whole contents
+        inferior_snapshots_.erase(message.buffer_name);
+        post([this, buffer_name = message.buffer_name] {
+            sent_buffers_.erase(buffer_name);
+        });
+
+        plot_callback_(message.buffer_name.c_str());
+    }
+
+    void request_buffer_batch(const PlotBufferBatchRequestMessage& message)
+    {
+        // The window may no longer hold these buffers, so the next plots must
+        // carry their whole contents
+        for (const auto& buffer_name : message.buffer_names) {
+            inferior_snapshots_.erase(buffer_name);
+        }
+        post([this, buffer_names = message.buffer_names] {
+            for (const auto& buffer_name : buffer_names) {
+                sent_buffers_.erase(buffer_name);
+            }
+        });
+
+        if (plot_buffers_callback_ == nullptr) {
+            for (const auto& buffer_name : message.buffer_names) {
+                plot_callback_(buffer_name.c_str());
+            }
+            return;
+        }
+
+        const auto py_buffer_names =
+            PyList_New(static_cast<Py_ssize_t>(message.buffer_names.size()));
+        if (py_buffer_names == nullptr) {
+            PyErr_Print();
+            return;
+        }
 
-    std::deque<std::string> get_observed_symbols()
-    {
-        assert(client_ != nullptr);
+        for (std::size_t i = 0; i < message.buffer_names.size(); ++i) {
+            const auto& buffer_name = message.buffer_names[i];
+            PyList_SetItem(py_buffer_names,
+                           static_cast<Py_ssize_t>(i),
+                           PyUnicode_FromString(buffer_name.c_str()));
+        }
 
-        auto message_composer = MessageComposer{};
-        message_composer.push(MessageType::GetObservedSymbols).send(client_);
+        const auto result = PyObject_CallFunctionObjArgs(
+            plot_buffers_callback_, py_buffer_names, nullptr);
+        Py_DECREF(py_buffer_names);
 
-        if (const auto response =
-                fetch_message(MessageType::GetObservedSymbolsResponse);
-            response != nullptr) {
-            return dynamic_cast<GetObservedSymbolsResponseMessage*>(
-                       response.get())
-                ->observed_symbols;
+        if (result == nullptr) {
+            PyErr_Print();
+            return;
         }
 
-        return {};
+        Py_DECREF(result);
     }
 
-
-    void
-    set_available_symbols(const std::deque<std::string>& available_vars) const
+    std::optional<GetObservedSymbolsResponseMessage>
+    fetch_observed_symbols_response()
     {
-        assert(client_ != nullptr);
+        // Requests received meanwhile are kept for run_event_loop()
+        if (!observed_symbols_response_.has_value()) {
+            try_read_incoming_messages();
+        }
 
-        auto message_composer = MessageComposer{};
-        message_composer.push(MessageType::SetAvailableSymbols)
-            .push(available_vars)
-            .send(client_);
+        return std::exchange(observed_symbols_response_, std::nullopt);
     }
 
-    void run_event_loop()
+
+    void send_buffer_contents(const BufferMetadata& metadata,
+                              const uint8_t* buff_ptr,
+                              const size_t buff_length,
+                              const SharedMemory* written_segment)
     {
-        try_read_incoming_messages(static_cast<int>(1000.0 / 5.0));
+        // Large payloads are written once into a shared memory segment, and
+        // only its name goes through the socket
+        if (buff_length >= shared_memory_threshold) {
+            if (const auto segment =
+                    written_segment != nullptr
+                        ? track_shared_segment(*written_segment)
+                        : write_shared_segment(buff_ptr, buff_length);
+                !segment.empty()) {
+                auto message_composer = MessageComposer{};
+                message_composer.push(MessageType::PlotBufferSharedContents)
+                    .push(metadata)
+                    .push(segment)
+                    .push(buff_length);
+                send(message_composer);
+                return;
+            }
+        }
 
-        auto plot_request_message = std::make_unique<UiMessage>();
-        while ((plot_request_message = try_get_stored_message(
-                    MessageType::PlotBufferRequest)) != nullptr) {
-            const PlotBufferRequestMessage* msg =
-                dynamic_cast<PlotBufferRequestMessage*>(
-                    plot_request_message.get());
-            plot_callback_(msg->buffer_name.c_str());
+        if (use_compression_ && payload_codec_ == PayloadCodec::ShuffleLz &&
+            buff_length >= compression_threshold) {
+            send_compressed_buffer_contents(metadata, buff_ptr, buff_length);
+            return;
         }
-    }
 
-    void plot_buffer(const std::string& variable_name_str,
-                     const std::string& display_name_str,
-                     const std::string& pixel_layout_str,
-                     const bool transpose_buffer,
-                     const int buff_width,
-                     const int buff_height,
-                     const int buff_channels,
-                     const int buff_stride,
-                     const BufferType buff_type,
-                     const uint8_t* buff_ptr,
-                     const size_t buff_length) const
-    {
         auto message_composer = MessageComposer{};
-        message_composer.push(MessageType::PlotBufferContents)
-            .push(variable_name_str)
-            .push(display_name_str)
-            .push(pixel_layout_str)
-            .push(transpose_buffer)
-            .push(buff_width)
-            .push(buff_height)
-            .push(buff_channels)
-            .push(buff_stride)
-            .push(buff_type)
-            .push(buff_ptr, buff_length)
-            .send(client_);
-    }
-
-    ~OidBridge()
-    {
-        ui_proc_.kill();
+        send(message_composer.push(MessageType::PlotBufferContents)
+                 .push(metadata)
+                 .push(buff_ptr, buff_length));
     }
 
-  private:
-    Process ui_proc_{};
-    QTcpServer server_{};
-    QTcpSocket* client_{nullptr};
-    std::string oid_path_{};
-
-    int (*plot_callback_)(const char*){};
-
-    std::map<MessageType, std::unique_ptr<UiMessage>> received_messages_{};
 
-    std::unique_ptr<UiMessage>
-    try_get_stored_message(const MessageType& msg_type)
+    void send_compressed_buffer_contents(const BufferMetadata& metadata,
+                                         const uint8_t* buff_ptr,
+                                         const size_t buff_length)
     {
-        if (const auto find_msg_handler = received_messages_.find(msg_type);
-            find_msg_handler != received_messages_.end()) {
-            auto result = std::move(find_msg_handler->second);
-            received_messages_.erase(find_msg_handler);
-            return result;
+        const auto chunks =
+            compress_payload(buff_ptr, buff_length, type_size(metadata.type));
+
+        auto message_composer = MessageComposer{};
+        message_composer.push(MessageType::PlotBufferCompressedContents)
+            .push(metadata)
+            .push(PayloadCodec::ShuffleLz)
+            .push(buff_length)
+            .push(chunks.size());
+
+        for (const auto& chunk : chunks) {
+            message_composer.push(chunk.raw_size)
+                .push(chunk.data.data(), chunk.data.size());
         }
 
-        return nullptr;
+        send(message_composer);
     }
 
 
-    void try_read_incoming_messages(const int msecs = 3000)
+    void send_buffer_preview(const BufferMetadata& metadata,
+                             const uint8_t* buff_ptr,
+                             const int downsampling)
     {
-        assert(client_ != nullptr);
-
-        do {
-            client_->waitForReadyRead(msecs);
-
-            if (client_->bytesAvailable() == 0) {
-                break;
-            }
+        const auto preview = downsample_buffer(buff_ptr,
+                                               metadata.width,
+                                               metadata.height,
+                                               metadata.channels,
+                                               metadata.stride,
+                                               metadata.type,
+                                               downsampling);
 
-            auto header = MessageType{};
-            client_->read(std::bit_cast<char*>(&header),
-                          static_cast<qint64>(sizeof(header)));
-
-            switch (header) {
-            case MessageType::PlotBufferRequest:
-                received_messages_[header] = decode_plot_buffer_request();
-                break;
-            case MessageType::GetObservedSymbolsResponse:
-                received_messages_[header] =
-                    decode_get_observed_symbols_response();
-                break;
-            default:
-                std::cerr
-                    << "[OpenImageDebugger] Received message with incorrect "
-                       "header"
-                    << std::endl;
-                break;
-            }
-        } while (client_->bytesAvailable() > 0);
+        auto message_composer = MessageComposer{};
+        send(message_composer.push(MessageType::PlotBufferPreview)
+                 .push(downsampling)
+                 .push(metadata)
+                 .push(preview.data(), preview.size()));
     }
 
 
-    [[nodiscard]] std::unique_ptr<UiMessage> decode_plot_buffer_request() const
+    void send_buffer_tiles(const BufferMetadata& metadata,
+                           const uint8_t* buff_ptr,
+                           const size_t buff_length,
+                           const std::vector<BufferTileRange>& tiles)
     {
-        assert(client_ != nullptr);
+        auto message_composer = MessageComposer{};
+        message_composer.push(MessageType::PlotBufferTiles)
+            .push(metadata)
+            .push(buff_length)
+            .push(tiles.size());
 
-        auto response        = std::make_unique<PlotBufferRequestMessage>();
-        auto message_decoder = MessageDecoder{client_};
-        message_decoder.read(response->buffer_name);
-        return response;
+        for (const auto& [offset, length] : tiles) {
+            message_composer.push(offset).push(buff_ptr + offset, length);
+        }
+
+        send(message_composer);
     }
 
-    [[nodiscard]] std::unique_ptr<UiMessage>
-    decode_get_observed_symbols_response() const
+
+    std::string write_shared_segment(const uint8_t* buff_ptr,
+                                     const size_t buff_length)
     {
-        assert(client_ != nullptr);
+        if (!use_shared_memory_ || buff_length > max_tracked_shared_bytes) {
+            return {};
+        }
 
-        auto response = std::make_unique<GetObservedSymbolsResponseMessage>();
+        auto segment = SharedMemory{};
+        if (!segment.create(buff_length)) {
+            return {};
+        }
 
-        auto message_decoder = MessageDecoder{client_};
-        message_decoder.read<std::deque<std::string>, std::string>(
-            response->observed_symbols);
+        std::memcpy(segment.data(), buff_ptr, buff_length);
 
-        return response;
+        return track_shared_segment(segment);
     }
 
-    std::unique_ptr<UiMessage> fetch_message(const MessageType& msg_type)
+
+    /**
+     * Remember a segment handed over to the window, so that it can be removed
+     * if the window does not get to consume it. The oldest segments are
+     * removed once the tracked ones would take more than
+     * max_tracked_shared_bytes, and larger segments are not handed over.
+     *
+     * @return name of the segment, or an empty string if it was removed and
+     *     its contents must be sent through the socket instead
+     */
+    std::string track_shared_segment(const SharedMemory& segment)
     {
-        // Return message if it was already received before
-        if (auto result = try_get_stored_message(msg_type); result != nullptr) {
-            return result;
+        if (segment.size() > max_tracked_shared_bytes) {
+            SharedMemory::remove(segment.name());
+            return {};
         }
 
-        // Try to fetch message
-        try_read_incoming_messages();
+        while (shared_segments_size_ + segment.size() >
+               max_tracked_shared_bytes) {
+            SharedMemory::remove(shared_segments_.front().name);
+            shared_segments_size_ -= shared_segments_.front().size;
+            shared_segments_.pop_front();
+        }
+        shared_segments_.push_back({segment.name(), segment.size()});
+        shared_segments_size_ += segment.size();
 
-        return try_get_stored_message(msg_type);
+        return segment.name();
     }
 
 
@@ -309,6 +1385,10 @@ class OidBridge
                           << std::endl;
             }
             client_ = server_.nextPendingConnection();
+
+            if (client_ != nullptr) {
+                client_->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            }
         }
     }
 };
@@ -332,6 +1412,40 @@ AppHandler oid_initialize(int (*plot_callback)(const char*),
      */
     const auto py_oid_path =
         PyDict_GetItemString(optional_parameters, "oid_path");
+    const auto py_shared_memory =
+        PyDict_GetItemString(optional_parameters, "shared_memory");
+    const auto py_compression =
+        PyDict_GetItemString(optional_parameters, "compression");
+    const auto py_region_callback =
+        PyDict_GetItemString(optional_parameters, "region_callback");
+    const auto py_plot_buffers_callback =
+        PyDict_GetItemString(optional_parameters, "plot_buffers_callback");
+    const auto py_symbols_callback =
+        PyDict_GetItemString(optional_parameters, "symbols_callback");
+
+    if (py_region_callback != nullptr &&
+        PyCallable_Check(py_region_callback) == 0) {
+        RAISE_PY_EXCEPTION(PyExc_TypeError,
+                           "region_callback given to oid_initialize is not "
+                           "callable");
+        return nullptr;
+    }
+
+    if (py_plot_buffers_callback != nullptr &&
+        PyCallable_Check(py_plot_buffers_callback) == 0) {
+        RAISE_PY_EXCEPTION(PyExc_TypeError,
+                           "plot_buffers_callback given to oid_initialize is "
+                           "not callable");
+        return nullptr;
+    }
+
+    if (py_symbols_callback != nullptr &&
+        PyCallable_Check(py_symbols_callback) == 0) {
+        RAISE_PY_EXCEPTION(PyExc_TypeError,
+                           "symbols_callback given to oid_initialize is not "
+                           "callable");
+        return nullptr;
+    }
 
     auto app = std::make_unique<OidBridge>(plot_callback);
 
@@ -341,6 +1455,26 @@ AppHandler oid_initialize(int (*plot_callback)(const char*),
         app->set_path(oid_path_str);
     }
 
+    if (py_shared_memory) {
+        app->set_shared_memory_enabled(PyObject_IsTrue(py_shared_memory) == 1);
+    }
+
+    if (py_compression) {
+        app->set_compression_enabled(PyObject_IsTrue(py_compression) == 1);
+    }
+
+    if (py_region_callback) {
+        app->set_region_callback(py_region_callback);
+    }
+
+    if (py_plot_buffers_callback) {
+        app->set_plot_buffers_callback(py_plot_buffers_callback);
+    }
+
+    if (py_symbols_callback) {
+        app->set_symbols_callback(py_symbols_callback);
+    }
+
     return app.release();
 }
 
@@ -428,6 +1562,22 @@ PyObject* oid_get_observed_buffers(AppHandler handler)
 }
 
 
+/**
+ * Copy a Python list of str objects. Requires the GIL.
+ */
+static std::deque<std::string> copy_py_string_list(PyObject* py_list)
+{
+    auto strings = std::deque<std::string>{};
+    for (Py_ssize_t pos = 0; pos < PyList_Size(py_list); ++pos) {
+        auto string = std::string{};
+        copy_py_string(string, PyList_GetItem(py_list, pos));
+        strings.push_back(std::move(string));
+    }
+
+    return strings;
+}
+
+
 void oid_set_available_symbols(const AppHandler handler,
                                PyObject* available_vars)
 {
@@ -444,19 +1594,33 @@ void oid_set_available_symbols(const AppHandler handler,
         return;
     }
 
-    auto available_vars_stl = std::deque<std::string>{};
-    for (Py_ssize_t pos = 0; pos < PyList_Size(available_vars); ++pos) {
-        auto var_name_str   = std::string{};
-        const auto listItem = PyList_GetItem(available_vars, pos);
-        copy_py_string(var_name_str, listItem);
-        available_vars_stl.push_back(var_name_str);
+    app->set_available_symbols(copy_py_string_list(available_vars));
+}
+
+
+void oid_update_available_symbols(const AppHandler handler,
+                                  PyObject* added_vars,
+                                  PyObject* removed_vars)
+{
+    const auto py_gil_raii = PyGILRAII{};
+
+    assert(PyList_Check(added_vars) && PyList_Check(removed_vars));
+
+    const auto app = static_cast<OidBridge*>(handler);
+
+    if (app == nullptr) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_update_available_symbols received null "
+                           "application handler");
+        return;
     }
 
-    app->set_available_symbols(available_vars_stl);
+    app->update_available_symbols(copy_py_string_list(added_vars),
+                                  copy_py_string_list(removed_vars));
 }
 
 
-void oid_run_event_loop(const AppHandler handler)
+PyObject* oid_get_event_descriptors(AppHandler handler)
 {
     const auto py_gil_raii = PyGILRAII{};
 
@@ -464,16 +1628,29 @@ void oid_run_event_loop(const AppHandler handler)
 
     if (app == nullptr) {
         RAISE_PY_EXCEPTION(PyExc_RuntimeError,
-                           "oid_run_event_loop received null application "
-                           "handler");
-        return;
+                           "oid_get_event_descriptors received null "
+                           "application handler");
+        return nullptr;
     }
 
-    app->run_event_loop();
+    const auto descriptors = app->get_event_descriptors();
+    const auto py_descriptors =
+        PyList_New(static_cast<Py_ssize_t>(descriptors.size()));
+    if (py_descriptors == nullptr) {
+        return nullptr;
+    }
+
+    for (std::size_t i = 0; i < descriptors.size(); ++i) {
+        PyList_SetItem(py_descriptors,
+                       static_cast<Py_ssize_t>(i),
+                       PyLong_FromLong(descriptors[i]));
+    }
+
+    return py_descriptors;
 }
 
 
-void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata)
+void oid_run_event_loop(const AppHandler handler)
 {
     const auto py_gil_raii = PyGILRAII{};
 
@@ -481,15 +1658,29 @@ void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata)
 
     if (app == nullptr) {
         RAISE_PY_EXCEPTION(PyExc_RuntimeError,
-                           "oid_plot_buffer received null application handler");
+                           "oid_run_event_loop received null application "
+                           "handler");
         return;
     }
 
+    app->run_event_loop();
+}
+
+
+/**
+ * Validate a buffer metadata dictionary given to oid_plot_buffer or
+ * oid_plot_buffers, and fill a plot request with its contents. Requires the
+ * GIL.
+ *
+ * @return false if a Python exception was raised
+ */
+static bool parse_plot_request(PyObject* buffer_metadata, PlotRequest& request)
+{
     if (!PyDict_Check(buffer_metadata)) {
         RAISE_PY_EXCEPTION(PyExc_TypeError,
                            "Invalid object given to plot_buffer (was expecting"
                            " a dict).");
-        return;
+        return false;
     }
 
     /*
@@ -516,48 +1707,114 @@ void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata)
         PyDict_GetItemString(buffer_metadata, "transpose_buffer");
     auto transpose_buffer = false;
     if (py_transpose_buffer != nullptr) {
-        CHECK_FIELD_TYPE(transpose_buffer, PyBool_Check, "transpose_buffer");
+        CHECK_FIELD_TYPE_RET(
+            transpose_buffer, PyBool_Check, "transpose_buffer", false);
         transpose_buffer = PyObject_IsTrue(py_transpose_buffer);
     }
 
+    const auto py_preview_downsampling =
+        PyDict_GetItemString(buffer_metadata, "preview_downsampling");
+    if (py_preview_downsampling != nullptr) {
+        CHECK_FIELD_TYPE_RET(
+            preview_downsampling, PY_INT_CHECK_FUNC, "plot_buffer", false);
+        const auto preview_downsampling = get_py_int(py_preview_downsampling);
+        if (PyErr_Occurred() != nullptr) {
+            return false;
+        }
+
+        if (preview_downsampling < 1 ||
+            preview_downsampling > max_preview_downsampling) {
+            RAISE_PY_EXCEPTION(PyExc_ValueError,
+                               "preview_downsampling must be between 1 and "
+                               "16");
+            return false;
+        }
+        request.preview_downsampling = static_cast<int>(preview_downsampling);
+    }
+
+    const auto py_pid     = PyDict_GetItemString(buffer_metadata, "pid");
+    const auto py_address = PyDict_GetItemString(buffer_metadata, "address");
+    if (py_pid != nullptr) {
+        CHECK_FIELD_TYPE_RET(pid, PY_INT_CHECK_FUNC, "plot_buffer", false);
+        CHECK_FIELD_PROVIDED_RET(address, "plot_buffer", false);
+        CHECK_FIELD_TYPE_RET(address, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    }
+
+    const auto py_region = PyDict_GetItemString(buffer_metadata, "region");
+    auto& region         = request.region;
+    if (py_region != nullptr) {
+        CHECK_FIELD_TYPE_RET(region, PyTuple_Check, "plot_buffer", false);
+        auto x      = 0LL;
+        auto y      = 0LL;
+        auto width  = 0LL;
+        auto height = 0LL;
+        region.emplace();
+        if (PyArg_ParseTuple(py_region,
+                             "LLLLi",
+                             &x,
+                             &y,
+                             &width,
+                             &height,
+                             &region->downsampling) == 0) {
+            return false;
+        }
+        region->x      = x;
+        region->y      = y;
+        region->width  = width;
+        region->height = height;
+    }
+
     /*
      * Check if expected fields were provided
      */
-    CHECK_FIELD_PROVIDED(variable_name, "plot_buffer");
-    CHECK_FIELD_PROVIDED(display_name, "plot_buffer");
-    CHECK_FIELD_PROVIDED(pointer, "plot_buffer");
-    CHECK_FIELD_PROVIDED(width, "plot_buffer");
-    CHECK_FIELD_PROVIDED(height, "plot_buffer");
-    CHECK_FIELD_PROVIDED(channels, "plot_buffer");
-    CHECK_FIELD_PROVIDED(type, "plot_buffer");
-    CHECK_FIELD_PROVIDED(row_stride, "plot_buffer");
-    CHECK_FIELD_PROVIDED(pixel_layout, "plot_buffer");
+    CHECK_FIELD_PROVIDED_RET(variable_name, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(display_name, "plot_buffer", false);
+    if (py_pid == nullptr) {
+        CHECK_FIELD_PROVIDED_RET(pointer, "plot_buffer", false);
+    }
+    CHECK_FIELD_PROVIDED_RET(width, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(height, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(channels, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(type, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(row_stride, "plot_buffer", false);
+    CHECK_FIELD_PROVIDED_RET(pixel_layout, "plot_buffer", false);
 
     /*
      * Check if expected fields have the correct types
      */
-    CHECK_FIELD_TYPE(variable_name, check_py_string_type, "plot_buffer");
-    CHECK_FIELD_TYPE(display_name, check_py_string_type, "plot_buffer");
-    CHECK_FIELD_TYPE(width, PY_INT_CHECK_FUNC, "plot_buffer");
-    CHECK_FIELD_TYPE(height, PY_INT_CHECK_FUNC, "plot_buffer");
-    CHECK_FIELD_TYPE(channels, PY_INT_CHECK_FUNC, "plot_buffer");
-    CHECK_FIELD_TYPE(type, PY_INT_CHECK_FUNC, "plot_buffer");
-    CHECK_FIELD_TYPE(row_stride, PY_INT_CHECK_FUNC, "plot_buffer");
-    CHECK_FIELD_TYPE(pixel_layout, check_py_string_type, "plot_buffer");
-
-    // Retrieve pointer to buffer
+    CHECK_FIELD_TYPE_RET(
+        variable_name, check_py_string_type, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(
+        display_name, check_py_string_type, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(width, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(height, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(channels, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(type, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(row_stride, PY_INT_CHECK_FUNC, "plot_buffer", false);
+    CHECK_FIELD_TYPE_RET(
+        pixel_layout, check_py_string_type, "plot_buffer", false);
+
+    // Retrieve pointer to buffer, unless its contents are to be read from
+    // the debugged process
     uint8_t* buff_ptr{nullptr};
     auto buff_size = std::size_t{0};
-    if (PyMemoryView_Check(py_pointer) != 0) {
+    if (py_pid != nullptr) {
+        request.inferior_pid = get_py_int(py_pid);
+        request.inferior_address =
+            static_cast<std::uint64_t>(get_py_int(py_address));
+        if (PyErr_Occurred() != nullptr) {
+            return false;
+        }
+    } else if (PyMemoryView_Check(py_pointer) != 0) {
         get_c_ptr_from_py_buffer(py_pointer, buff_ptr, buff_size);
     } else {
         RAISE_PY_EXCEPTION(PyExc_TypeError,
                            "Could not retrieve C pointer to provided buffer");
-        return;
+        return false;
     }
 
     /*
-     * Send buffer contents
+     * Copy buffer description
      */
     auto variable_name_str = std::string{};
     auto display_name_str  = std::string{};
@@ -567,43 +1824,243 @@ void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata)
     copy_py_string(display_name_str, py_display_name);
     copy_py_string(pixel_layout_str, py_pixel_layout);
 
-    const auto buff_width    = static_cast<int>(get_py_int(py_width));
-    const auto buff_height   = static_cast<int>(get_py_int(py_height));
-    const auto buff_channels = static_cast<int>(get_py_int(py_channels));
-    const auto buff_stride   = static_cast<int>(get_py_int(py_row_stride));
+    const auto buff_width        = get_py_int(py_width);
+    const auto buff_height       = get_py_int(py_height);
+    const auto py_channels_value = get_py_int(py_channels);
+    const auto buff_stride       = get_py_int(py_row_stride);
 
     const auto buff_type = static_cast<BufferType>(get_py_int(py_type));
 
-    const auto buff_size_expected = std::size_t{
-        static_cast<size_t>(buff_stride * buff_height * buff_channels) *
-        type_size(buff_type)};
+    // Values that do not fit in 64 bits leave an OverflowError behind
+    if (PyErr_Occurred() != nullptr) {
+        return false;
+    }
 
-    if (buff_ptr == nullptr) {
+    if (buff_width < 0 || buff_height < 0 || buff_stride < 0 ||
+        py_channels_value < 1 ||
+        py_channels_value > std::numeric_limits<int>::max()) {
+        RAISE_PY_EXCEPTION(PyExc_ValueError,
+                           "oid_plot_buffer received invalid buffer "
+                           "dimensions");
+        return false;
+    }
+    const auto buff_channels = static_cast<int>(py_channels_value);
+
+    // Computed in 64 bits, since buffers may be larger than 2 GiB
+    auto buff_size_expected = static_cast<std::size_t>(buff_stride) *
+                              static_cast<std::size_t>(buff_height) *
+                              static_cast<std::size_t>(buff_channels) *
+                              type_size(buff_type);
+
+    if (py_pid != nullptr) {
+        if (request.inferior_address == 0) {
+            RAISE_PY_EXCEPTION(
+                PyExc_TypeError,
+                "oid_plot_buffer received nullptr as buffer address");
+            return false;
+        }
+    } else if (buff_ptr == nullptr) {
         RAISE_PY_EXCEPTION(
             PyExc_TypeError,
             "oid_plot_buffer received nullptr as buffer pointer");
-        return;
+        return false;
+    }
+
+    if (region.has_value()) {
+        if (region->x < 0 || region->y < 0 || region->width <= 0 ||
+            region->height <= 0 || region->downsampling < 1 ||
+            region->x + region->width > buff_width ||
+            region->y + region->height > buff_height) {
+            RAISE_PY_EXCEPTION(PyExc_ValueError,
+                               "oid_plot_buffer received a region outside of "
+                               "the buffer");
+            return false;
+        }
+
+        // Only the sampled rows of the region were read, whole
+        buff_size_expected =
+            static_cast<size_t>(region->sampled_height()) *
+            static_cast<size_t>(region->width) *
+            static_cast<size_t>(buff_channels) * type_size(buff_type);
     }
 
-    if (buff_size < buff_size_expected) {
+    if (py_pid != nullptr) {
+        buff_size = buff_size_expected;
+    } else if (buff_size < buff_size_expected) {
         auto ss = std::stringstream{};
         ss << "oid_plot_buffer received shorter buffer then expected";
         ss << ". Variable name " << variable_name_str;
         ss << ". Expected " << buff_size_expected << "bytes";
         ss << ". Received " << buff_size << "bytes";
         RAISE_PY_EXCEPTION(PyExc_TypeError, ss.str().c_str());
+        return false;
+    }
+
+    request.metadata      = BufferMetadata{.variable_name = variable_name_str,
+                                           .display_name  = display_name_str,
+                                           .pixel_layout  = pixel_layout_str,
+                                           .transpose     = transpose_buffer,
+                                           .width         = buff_width,
+                                           .height        = buff_height,
+                                           .channels      = buff_channels,
+                                           .stride        = buff_stride,
+                                           .type          = buff_type};
+    request.buff_ptr      = buff_ptr;
+    request.buff_size     = buff_size;
+    request.payload_owner = py_pid == nullptr ? py_pointer : nullptr;
+
+    return true;
+}
+
+
+void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata)
+{
+    const auto py_gil_raii = PyGILRAII{};
+
+    const auto app = static_cast<OidBridge*>(handler);
+
+    if (app == nullptr) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_plot_buffer received null application handler");
+        return;
+    }
+
+    app->release_sent_payloads();
+
+    auto request = PlotRequest{};
+    if (!parse_plot_request(buffer_metadata, request)) {
+        return;
+    }
+
+    // The memoryview is kept alive until its contents are sent, while the
+    // debugger carries on. The GIL is only released here, since reading from
+    // the debugged process and queueing may take a while.
+    Py_XINCREF(request.payload_owner);
+
+    auto is_read = true;
+
+    Py_BEGIN_ALLOW_THREADS
+
+    auto requests = std::vector<PlotRequest>{};
+    requests.push_back(std::move(request));
+    is_read = app->read_inferior_payloads(requests) == 0;
+    if (is_read) {
+        app->plot_buffer(std::move(requests.front()));
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if (!is_read) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_plot_buffer could not read the buffer from the "
+                           "debugged process");
+    }
+}
+
+
+void oid_plot_buffers(AppHandler handler,
+                      PyObject* buffer_metadata_list,
+                      const int is_first_sent_apart)
+{
+    const auto py_gil_raii = PyGILRAII{};
+
+    const auto app = static_cast<OidBridge*>(handler);
+
+    if (app == nullptr) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_plot_buffers received null application "
+                           "handler");
+        return;
+    }
+
+    if (!PyList_Check(buffer_metadata_list)) {
+        RAISE_PY_EXCEPTION(PyExc_TypeError,
+                           "Invalid object given to plot_buffers (was "
+                           "expecting a list).");
+        return;
+    }
+
+    app->release_sent_payloads();
+
+    // Nothing is plotted unless every buffer is valid
+    auto requests = std::vector<PlotRequest>(
+        static_cast<std::size_t>(PyList_Size(buffer_metadata_list)));
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        if (!parse_plot_request(
+                PyList_GetItem(buffer_metadata_list,
+                               static_cast<Py_ssize_t>(i)),
+                requests[i])) {
+            return;
+        }
+    }
+
+    if (requests.empty()) {
         return;
     }
 
-    app->plot_buffer(variable_name_str,
-                     display_name_str,
-                     pixel_layout_str,
-                     transpose_buffer,
-                     buff_width,
-                     buff_height,
-                     buff_channels,
-                     buff_stride,
-                     buff_type,
-                     buff_ptr,
-                     buff_size);
+    for (const auto& request : requests) {
+        Py_XINCREF(request.payload_owner);
+    }
+
+    // Buffers that cannot be read from the debugged process are left out
+    auto unread_buffers = std::size_t{0};
+
+    Py_BEGIN_ALLOW_THREADS
+
+    // The first buffer is only sent apart if it could be read
+    const auto first_variable = requests.front().metadata.variable_name;
+    unread_buffers = app->read_inferior_payloads(requests);
+
+    if (!requests.empty()) {
+        const auto is_first_read =
+            requests.front().metadata.variable_name == first_variable;
+        app->plot_buffers(std::move(requests),
+                          is_first_sent_apart != 0 && is_first_read);
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if (unread_buffers > 0) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_plot_buffers could not read some buffers from "
+                           "the debugged process");
+    }
+}
+
+
+int oid_can_read_inferior_memory(const AppHandler handler,
+                                 const int64_t pid,
+                                 const uint64_t address)
+{
+    const auto py_gil_raii = PyGILRAII{};
+
+    const auto app = static_cast<OidBridge*>(handler);
+
+    if (app == nullptr) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_can_read_inferior_memory received null "
+                           "application handler");
+        return 0;
+    }
+
+    return app->can_read_inferior_memory(pid, address) ? 1 : 0;
+}
+
+
+int oid_get_pending_plots(const AppHandler handler)
+{
+    const auto py_gil_raii = PyGILRAII{};
+
+    const auto app = static_cast<OidBridge*>(handler);
+
+    if (app == nullptr) {
+        RAISE_PY_EXCEPTION(PyExc_RuntimeError,
+                           "oid_get_pending_plots received null application "
+                           "handler");
+        return 0;
+    }
+
+    app->release_sent_payloads();
+
+    return app->get_pending_plots();
 }
@@ -28,6 +28,8 @@
 
 #include <Python.h>
 
+#include <stdint.h>
+
 #ifndef OID_API
 #if __GNUC__ >= 4
 #define OID_API __attribute__((visibility("default")))
@@ -50,7 +52,21 @@ typedef void* AppHandler;
  * @param plot_callback  Callback function to be called when the user requests
  *     a symbol name from the OpenImageDebugger window
  * @param optional_parameters  Dictionary with the following optional members:
- *   - oid_path  Path where the plugin is located
+ *   - oid_path       Path where the plugin is located
+ *   - shared_memory  If False, buffer contents are always sent through the
+ *                    socket instead of shared memory segments (default: True)
+ *   - compression    If False, buffer contents sent through the socket are
+ *                    never compressed (default: True)
+ *   - region_callback  Callable invoked as region_callback(name, x, y, width,
+ *                    height, downsampling) when the window needs a region of
+ *                    a buffer that is too large to be plotted whole
+ *   - plot_buffers_callback  Callable invoked as plot_buffers_callback(names)
+ *                    when the window requests several buffers at once. If
+ *                    absent, plot_callback is called once per buffer.
+ *   - symbols_callback  Callable invoked as symbols_callback() when the
+ *                    window needs the symbols available in the current
+ *                    context, which it then expects through
+ *                    oid_update_available_symbols()
  * @return  Application context
  */
 OID_API
@@ -91,7 +107,7 @@ int oid_is_window_ready(AppHandler handler);
  * Get a list of the names of all buffers being visualized
  *
  * Returns a python list object with the names of all buffers present in the
- * visualization list.
+ * visualization list. The buffer selected in the window, if any, comes first.
  *
  * @param handler  Window handler, generated by oid_initialize()
  * @return  Python list object containing python str objects with the names of
@@ -115,11 +131,44 @@ OID_API
 void oid_set_available_symbols(AppHandler handler, PyObject* available_vars);
 
 
+/**
+ * Update the list of symbols available in the current context
+ *
+ * Only sends the changes since the symbols were last set or updated, which is
+ * cheaper than oid_set_available_symbols() when most of them remain.
+ *
+ * @param handler  Window handler, generated by oid_initialize()
+ * @param added_vars  Python list of python str objects with the names of
+ *     symbols that became available
+ * @param removed_vars  Python list of python str objects with the names of
+ *     symbols that are no longer available
+ */
+OID_API
+void oid_update_available_symbols(AppHandler handler,
+                                  PyObject* added_vars,
+                                  PyObject* removed_vars);
+
+
+/**
+ * Get the file descriptors that become readable when the UI sent requests
+ *
+ * The debugger may wait on them with select() or poll() and only call
+ * oid_run_event_loop() once any of them is readable, instead of polling it.
+ *
+ * @param handler  Window handler, generated by oid_initialize()
+ * @return  Python list object containing the descriptors as python int
+ *     objects. It is empty if the platform does not support waiting on them,
+ *     in which case oid_run_event_loop() must be called periodically.
+ */
+OID_API
+PyObject* oid_get_event_descriptors(AppHandler handler);
+
+
 /**
  * Process pending events related to communication with UI
  *
  * Must be called in order for requests from the UI to reach the debugger
- * bridge.
+ * bridge. Does not wait for requests that did not arrive yet.
  *
  * @param handler  Window handler, generated by oid_initialize()
  */
@@ -132,7 +181,8 @@ void oid_run_event_loop(AppHandler handler);
  *
  * @param handler  Handler of the window where the buffer should be plotted
  * @param buffer_metadata  Python dictionary with the following elements:
- *     - [pointer     ] PyMemoryView object wrapping the target buffer
+ *     - [pointer     ] PyMemoryView object wrapping the target buffer. May be
+ *                      omitted if pid and address are given.
  *     - [display_name] Variable name as it shall be displayed
  *     - [width       ] Buffer width, in pixels
  *     - [height      ] Buffer height, in pixels
@@ -140,10 +190,74 @@ void oid_run_event_loop(AppHandler handler);
  *     - [type        ] Buffer type (see symbols.py for details)
  *     - [row_stride  ] Row stride, in pixels
  *     - [pixel_layout] String defining pixel channel layout (e.g. 'rgba')
+ *     Optionally, it may also contain:
+ *     - [preview_downsampling] If greater than 1, a preview box filtered to
+ *           1/preview_downsampling of the width and height (at most 16) is
+ *           sent ahead of the full resolution contents
+ *     - [region] Tuple (x, y, width, height, downsampling). If provided, the
+ *           pointer only holds every downsampling-th row of that rectangle,
+ *           each row being width pixels long, and only the rectangle is sent
+ *     - [pid, address] Id of the debugged process and address of the buffer
+ *           in it. If provided, the buffer contents are read straight from
+ *           the process before this function returns, instead of being given
+ *           as pointer (see oid_can_read_inferior_memory()). Rows are read
+ *           without the padding that follows them, and sent packed. Where
+ *           the kernel tracks written pages (Linux soft-dirty bits), a buffer
+ *           that was not written since it was last read this way is neither
+ *           read nor sent again; the window is only told it is unchanged.
+ *
+ * The buffer is sent asynchronously: a reference to the pointer object is kept
+ * until its contents went out, and this function returns as soon as the plot
+ * is queued. It only blocks while too many plots are already pending.
  * */
 OID_API
 void oid_plot_buffer(AppHandler handler, PyObject* buffer_metadata);
 
+
+/**
+ * Add several buffers to the plot list, which the window displays together
+ *
+ * Buffers are read from the debugged process at once and sent as one batch,
+ * and previews are never sent ahead of them. If any of the dictionaries is
+ * invalid, no buffer is plotted.
+ *
+ * @param handler  Handler of the window where the buffers should be plotted
+ * @param buffer_metadata_list  Python list of dictionaries, each laid out as
+ *     the buffer_metadata parameter of oid_plot_buffer()
+ * @param is_first_sent_apart  Non-zero if the first buffer must be sent in a
+ *     batch of its own, ahead of the others
+ */
+OID_API
+void oid_plot_buffers(AppHandler handler,
+                      PyObject* buffer_metadata_list,
+                      int is_first_sent_apart);
+
+
+/**
+ * Check whether the bridge can read the memory of the debugged process by
+ * itself, which lets oid_plot_buffer skip the copy made by the debugger
+ *
+ * @param handler  Window handler, generated by oid_initialize()
+ * @param pid  Id of the debugged process, which must run on this machine
+ * @param address  Readable address in the debugged process
+ * @return  1 if direct reads are supported, 0 otherwise
+ */
+OID_API
+int oid_can_read_inferior_memory(AppHandler handler,
+                                 int64_t pid,
+                                 uint64_t address);
+
+
+/**
+ * Get the number of plots that were queued by oid_plot_buffer and not entirely
+ * sent to the window yet
+ *
+ * @param handler  Window handler, generated by oid_initialize()
+ * @return  Number of pending plots
+ */
+OID_API
+int oid_get_pending_plots(AppHandler handler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "sender_thread.h"
+
+#include <utility>
+
+
+namespace oid
+{
+
+SenderThread::SenderThread(const std::size_t max_queued_jobs)
+    : max_queued_jobs_{max_queued_jobs}
+    , thread_{&SenderThread::run, this}
+{
+}
+
+
+SenderThread::~SenderThread()
+{
+    {
+        const auto lock    = std::scoped_lock{mutex_};
+        is_stop_requested_ = true;
+    }
+    job_queued_.notify_one();
+
+    thread_.join();
+}
+
+
+void SenderThread::enqueue(Job&& job)
+{
+    {
+        auto lock = std::unique_lock{mutex_};
+        job_dequeued_.wait(lock,
+                           [&] { return jobs_.size() < max_queued_jobs_; });
+        jobs_.push_back(std::move(job));
+    }
+    job_queued_.notify_one();
+}
+
+
+void SenderThread::run()
+{
+    while (true) {
+        auto job = Job{};
+
+        {
+            auto lock = std::unique_lock{mutex_};
+            job_queued_.wait(
+                lock, [&] { return is_stop_requested_ || !jobs_.empty(); });
+
+            if (jobs_.empty()) {
+                return;
+            }
+
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job_dequeued_.notify_one();
+
+        job();
+    }
+}
+
+} // namespace oid
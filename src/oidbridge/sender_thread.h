@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef SENDER_THREAD_H_
+#define SENDER_THREAD_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace oid
+{
+
+/**
+ * Runs the jobs queued by the debugger thread, in order, on a dedicated
+ * thread, so that encoding and writing buffer payloads does not hold the
+ * debugger back. The queue is bounded: once it is full, enqueue blocks until
+ * a job finishes, which keeps the memory retained by pending payloads in
+ * check.
+ */
+class SenderThread final
+{
+  public:
+    using Job = std::function<void()>;
+
+    explicit SenderThread(std::size_t max_queued_jobs);
+
+    SenderThread(const SenderThread&)            = delete;
+    SenderThread& operator=(const SenderThread&) = delete;
+
+    /**
+     * Jobs still queued are run before the thread is joined, since they may
+     * own resources that must be released
+     */
+    ~SenderThread();
+
+    /**
+     * Queue a job, blocking the caller while the queue is full
+     */
+    void enqueue(Job&& job);
+
+  private:
+    std::size_t max_queued_jobs_{};
+
+    std::mutex mutex_{};
+    std::condition_variable job_queued_{};
+    std::condition_variable job_dequeued_{};
+    std::deque<Job> jobs_{};
+    bool is_stop_requested_{false};
+
+    std::thread thread_{};
+
+    void run();
+};
+
+} // namespace oid
+
+#endif // SENDER_THREAD_H_
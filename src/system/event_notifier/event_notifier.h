@@ -0,0 +1,78 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef SYSTEM_EVENT_NOTIFIER_H_
+#define SYSTEM_EVENT_NOTIFIER_H_
+
+#include <memory>
+
+namespace oid
+{
+
+class EventNotifierImpl;
+
+/**
+ * File descriptor that becomes readable once notified, until it is cleared
+ *
+ * The debugger bridge notifies it when messages from the window are waiting to
+ * be handled, so that the debugger can wait for it alongside the socket
+ * instead of polling. The network thread of the window is woken up the same
+ * way when the GUI has work for it.
+ */
+class EventNotifier final
+{
+  public:
+    EventNotifier();
+
+    /**
+     * Make the descriptor readable. Notifying it more than once before it is
+     * cleared has no further effect.
+     */
+    void notify() const;
+
+    /**
+     * Make the descriptor no longer readable
+     */
+    void clear() const;
+
+    /**
+     * @return descriptor that can be waited upon with select() or poll(), or
+     *     -1 if the platform does not support it
+     */
+    [[nodiscard]] int descriptor() const;
+
+  private:
+    /**
+     * Initialize pimpl according to platform
+     */
+    void createImpl();
+
+    // pimpl idiom
+    std::shared_ptr<EventNotifierImpl> impl_{};
+};
+
+} // namespace oid
+
+#endif // SYSTEM_EVENT_NOTIFIER_H_
@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "event_notifier.h"
+#include "event_notifier_impl.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+namespace oid
+{
+
+/**
+ * Backed by an eventfd on Linux, and by a pipe on other Unix systems
+ */
+class EventNotifierImplUnix final : public EventNotifierImpl
+{
+  public:
+    EventNotifierImplUnix()
+    {
+#if defined(__linux__)
+        read_fd_  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        write_fd_ = read_fd_;
+#else
+        auto fds = std::array<int, 2>{-1, -1};
+        if (pipe(fds.data()) == 0) {
+            for (const auto fd : fds) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+            read_fd_  = fds[0];
+            write_fd_ = fds[1];
+        }
+#endif
+    }
+
+    EventNotifierImplUnix(const EventNotifierImplUnix&) = delete;
+
+    EventNotifierImplUnix(EventNotifierImplUnix&&) = delete;
+
+    EventNotifierImplUnix& operator=(const EventNotifierImplUnix&) = delete;
+
+    EventNotifierImplUnix& operator=(EventNotifierImplUnix&&) = delete;
+
+    ~EventNotifierImplUnix() noexcept override
+    {
+        if (write_fd_ >= 0 && write_fd_ != read_fd_) {
+            close(write_fd_);
+        }
+        if (read_fd_ >= 0) {
+            close(read_fd_);
+        }
+    }
+
+    void notify() override
+    {
+        // Only one notification is written until it is cleared, so that a
+        // pipe never fills up
+        if (write_fd_ < 0 || is_notified_.exchange(true)) {
+            return;
+        }
+
+        const auto value = std::uint64_t{1};
+        [[maybe_unused]] const auto written =
+            write(write_fd_, &value, sizeof(value));
+    }
+
+    void clear() override
+    {
+        if (read_fd_ < 0 || !is_notified_.exchange(false)) {
+            return;
+        }
+
+        auto value = std::uint64_t{};
+        while (read(read_fd_, &value, sizeof(value)) > 0) {
+        }
+    }
+
+    [[nodiscard]] int descriptor() const override
+    {
+        return read_fd_;
+    }
+
+  private:
+    int read_fd_{-1};
+    int write_fd_{-1};
+    std::atomic<bool> is_notified_{false};
+};
+
+void EventNotifier::createImpl()
+{
+    impl_ = std::make_shared<EventNotifierImplUnix>();
+}
+
+} // namespace oid
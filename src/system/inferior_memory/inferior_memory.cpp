@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "inferior_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "inferior_memory_impl.h"
+
+namespace oid
+{
+
+namespace
+{
+
+// Reads smaller than this are not worth spawning a thread for
+constexpr std::size_t min_bytes_per_thread = 8 << 20;
+constexpr std::size_t max_read_threads     = 4;
+
+} // namespace
+
+
+bool read_inferior_memory(const std::int64_t pid,
+                          const std::vector<InferiorMemoryRange>& ranges,
+                          std::uint8_t* destination)
+{
+    auto total_length = std::size_t{0};
+    for (const auto& range : ranges) {
+        total_length += range.length;
+    }
+
+    const auto thread_count = std::clamp<std::size_t>(
+        total_length / min_bytes_per_thread,
+        1,
+        std::min<std::size_t>(
+            max_read_threads,
+            std::max(1U, std::thread::hardware_concurrency())));
+
+    if (thread_count == 1) {
+        return read_inferior_ranges(pid, ranges, destination);
+    }
+
+    // Each thread reads an equal share of the destination, which may start
+    // and end in the middle of a range
+    const auto part_length = (total_length + thread_count - 1) / thread_count;
+
+    auto parts       = std::vector<std::vector<InferiorMemoryRange>>(1);
+    auto part_filled = std::size_t{0};
+    for (auto range : ranges) {
+        while (range.length > 0) {
+            if (part_filled == part_length) {
+                parts.emplace_back();
+                part_filled = 0;
+            }
+
+            const auto length =
+                std::min(range.length, part_length - part_filled);
+            parts.back().push_back({range.address, length});
+
+            range.address += length;
+            range.length -= length;
+            part_filled += length;
+        }
+    }
+
+    auto is_successful = std::atomic<bool>{true};
+    const auto read_part = [&](const std::size_t p) {
+        if (!read_inferior_ranges(
+                pid, parts[p], destination + p * part_length)) {
+            is_successful = false;
+        }
+    };
+
+    auto workers = std::vector<std::thread>{};
+    for (std::size_t p = 1; p < parts.size(); ++p) {
+        workers.emplace_back(read_part, p);
+    }
+
+    read_part(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return is_successful;
+}
+
+} // namespace oid
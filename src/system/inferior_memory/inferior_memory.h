@@ -0,0 +1,89 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef SYSTEM_INFERIOR_MEMORY_H_
+#define SYSTEM_INFERIOR_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace oid
+{
+
+/**
+ * Contiguous range of the address space of the debugged process
+ */
+struct InferiorMemoryRange
+{
+    std::uint64_t address{};
+    std::size_t length{};
+};
+
+/**
+ * Read memory straight from the debugged process, without going through the
+ * debugger. Large reads are split across several threads.
+ *
+ * The debugger process must be allowed to read the memory of the inferior,
+ * which is usually the case since it traces it.
+ *
+ * @param pid id of the debugged process
+ * @param ranges ranges to be read, in order
+ * @param destination receives the contents of all ranges, one after the other
+ * @return true if every byte could be read, false otherwise or if the platform
+ *     does not support direct reads
+ */
+[[nodiscard]] bool
+read_inferior_memory(std::int64_t pid,
+                     const std::vector<InferiorMemoryRange>& ranges,
+                     std::uint8_t* destination);
+
+/**
+ * Start tracking which pages of the debugged process are written from now on.
+ * Tracking covers the whole address space, so it restarts for every buffer at
+ * once.
+ *
+ * @param pid id of the debugged process
+ * @return true if tracking started, false if the platform or the kernel does
+ *     not support it
+ */
+[[nodiscard]] bool clear_inferior_written_pages(std::int64_t pid);
+
+/**
+ * Check whether a range of the debugged process may have been written since
+ * the last call to clear_inferior_written_pages
+ *
+ * @param pid id of the debugged process
+ * @param range range to be checked
+ * @return false only if no page of the range was written; true otherwise or
+ *     if that cannot be determined
+ */
+[[nodiscard]] bool
+was_inferior_memory_written(std::int64_t pid,
+                            const InferiorMemoryRange& range);
+
+} // namespace oid
+
+#endif // SYSTEM_INFERIOR_MEMORY_H_
@@ -0,0 +1,258 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "inferior_memory.h"
+#include "inferior_memory_impl.h"
+
+#if defined(__linux__)
+#include <algorithm>
+#include <string>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace oid
+{
+
+#if defined(__linux__)
+
+bool read_inferior_ranges(const std::int64_t pid,
+                          const std::vector<InferiorMemoryRange>& ranges,
+                          std::uint8_t* destination)
+{
+    constexpr auto max_vectors = std::size_t{IOV_MAX};
+
+    // The destination is contiguous, so a single local vector covers each
+    // batch of remote ones
+    auto remote_vectors = std::vector<iovec>{};
+    remote_vectors.reserve(std::min(ranges.size(), max_vectors));
+
+    auto first_range = std::size_t{0};
+    while (first_range < ranges.size()) {
+        remote_vectors.clear();
+        auto batch_length = std::size_t{0};
+        for (auto r = first_range;
+             r < ranges.size() && remote_vectors.size() < max_vectors;
+             ++r) {
+            remote_vectors.push_back(
+                {reinterpret_cast<void*>(ranges[r].address), ranges[r].length});
+            batch_length += ranges[r].length;
+        }
+        first_range += remote_vectors.size();
+
+        // Partial reads happen when a range crosses into unmapped pages, which
+        // makes the whole read fail
+        auto local_vector = iovec{destination, batch_length};
+        const auto read_length =
+            process_vm_readv(static_cast<pid_t>(pid),
+                             &local_vector,
+                             1,
+                             remote_vectors.data(),
+                             remote_vectors.size(),
+                             0);
+        if (read_length < 0 ||
+            static_cast<std::size_t>(read_length) != batch_length) {
+            return false;
+        }
+
+        destination += batch_length;
+    }
+
+    return true;
+}
+
+
+namespace
+{
+
+/**
+ * File descriptor that is closed when it goes out of scope
+ */
+class ProcFile
+{
+  public:
+    ProcFile(const std::int64_t pid, const char* name, const int flags)
+        : fd_{open(("/proc/" + std::to_string(pid) + "/" + name).c_str(),
+                   flags | O_CLOEXEC)}
+    {
+    }
+
+    ~ProcFile()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    ProcFile(const ProcFile&)            = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    [[nodiscard]] int fd() const
+    {
+        return fd_;
+    }
+
+  private:
+    int fd_;
+};
+
+
+// Each page is described in the pagemap by a 64 bit entry, whose bit 55 is set
+// once the page is written after its soft-dirty bit was cleared
+constexpr auto soft_dirty_bit = std::uint64_t{1} << 55;
+
+
+/**
+ * Kernels built without soft-dirty support still accept clear_refs requests,
+ * but never set the bit. New pages start out soft-dirty, which tells both
+ * cases apart without touching the soft-dirty bits of any page in use.
+ */
+bool is_soft_dirty_supported()
+{
+    static const auto is_supported = [] {
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto* page = mmap(nullptr,
+                          page_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1,
+                          0);
+        if (page == MAP_FAILED) {
+            return false;
+        }
+
+        *static_cast<volatile std::uint8_t*>(page) = 1;
+
+        const auto pagemap = ProcFile{getpid(), "pagemap", O_RDONLY};
+        auto entry         = std::uint64_t{0};
+        const auto offset  = static_cast<off_t>(
+            reinterpret_cast<std::uintptr_t>(page) / page_size *
+            sizeof(entry));
+        const auto has_entry =
+            pagemap.fd() >= 0 &&
+            pread(pagemap.fd(), &entry, sizeof(entry), offset) ==
+                static_cast<ssize_t>(sizeof(entry));
+
+        munmap(page, page_size);
+
+        return has_entry && (entry & soft_dirty_bit) != 0;
+    }();
+
+    return is_supported;
+}
+
+} // namespace
+
+
+bool clear_inferior_written_pages(const std::int64_t pid)
+{
+    if (!is_soft_dirty_supported()) {
+        return false;
+    }
+
+    // Writing 4 clears the soft-dirty bits of every page of the process
+    const auto clear_refs = ProcFile{pid, "clear_refs", O_WRONLY};
+    return clear_refs.fd() >= 0 && write(clear_refs.fd(), "4", 1) == 1;
+}
+
+
+bool was_inferior_memory_written(const std::int64_t pid,
+                                 const InferiorMemoryRange& range)
+{
+    if (range.length == 0) {
+        return false;
+    }
+
+    const auto pagemap = ProcFile{pid, "pagemap", O_RDONLY};
+    if (pagemap.fd() < 0) {
+        return true;
+    }
+
+    constexpr auto entries_per_read = std::size_t{4096};
+
+    const auto page_size = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    const auto first_page = range.address / page_size;
+    const auto last_page  = (range.address + range.length - 1) / page_size;
+
+    auto entries = std::vector<std::uint64_t>(
+        std::min<std::uint64_t>(last_page - first_page + 1, entries_per_read));
+
+    for (auto page = first_page; page <= last_page;) {
+        const auto entry_count = std::min<std::uint64_t>(
+            last_page - page + 1, entries.size());
+        const auto read_length = entry_count * sizeof(std::uint64_t);
+
+        if (pread(pagemap.fd(),
+                  entries.data(),
+                  read_length,
+                  static_cast<off_t>(page * sizeof(std::uint64_t))) !=
+            static_cast<ssize_t>(read_length)) {
+            return true;
+        }
+
+        for (std::size_t e = 0; e < entry_count; ++e) {
+            if ((entries[e] & soft_dirty_bit) != 0) {
+                return true;
+            }
+        }
+
+        page += entry_count;
+    }
+
+    return false;
+}
+
+#else
+
+// Other Unix systems, such as macOS, have no equivalent that does not require
+// the task port of the inferior
+bool read_inferior_ranges(const std::int64_t /* pid */,
+                          const std::vector<InferiorMemoryRange>& /* ranges */,
+                          std::uint8_t* /* destination */)
+{
+    return false;
+}
+
+
+bool clear_inferior_written_pages(const std::int64_t /* pid */)
+{
+    return false;
+}
+
+
+bool was_inferior_memory_written(const std::int64_t /* pid */,
+                                 const InferiorMemoryRange& /* range */)
+{
+    return true;
+}
+
+#endif
+
+} // namespace oid
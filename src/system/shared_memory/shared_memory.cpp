@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "shared_memory.h"
+
+#include "shared_memory_impl.h"
+
+namespace oid
+{
+
+SharedMemory::SharedMemory()
+{
+    createImpl();
+}
+
+
+bool SharedMemory::create(const std::size_t size)
+{
+    return impl_->create(size);
+}
+
+
+bool SharedMemory::open(const std::string& name, const std::size_t size)
+{
+    return impl_->open(name, size);
+}
+
+
+void SharedMemory::unlink()
+{
+    impl_->unlink();
+}
+
+
+const std::string& SharedMemory::name() const
+{
+    return impl_->name();
+}
+
+
+std::uint8_t* SharedMemory::data() const
+{
+    return impl_->data();
+}
+
+
+std::size_t SharedMemory::size() const
+{
+    return impl_->size();
+}
+
+} // namespace oid
@@ -0,0 +1,97 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef SYSTEM_SHARED_MEMORY_H_
+#define SYSTEM_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace oid
+{
+
+class SharedMemoryImpl;
+
+/**
+ * Named memory segment that can be mapped by more than one process
+ *
+ * The debugger bridge writes buffer payloads into a segment and only sends its
+ * name to the window, which maps the very same pages instead of receiving the
+ * payload through the socket.
+ */
+class SharedMemory final
+{
+  public:
+    SharedMemory();
+
+    /**
+     * Create a new segment with a unique name and map it for writing
+     * @param size segment size, in bytes
+     * @return true on success, false if the segment could not be created or if
+     *     the platform does not support shared memory segments
+     */
+    [[nodiscard]] bool create(std::size_t size);
+
+    /**
+     * Map an existing segment created by another process
+     * @param name segment name, as returned by name() in the creator process
+     * @param size segment size, in bytes
+     * @return true on success, false otherwise
+     */
+    [[nodiscard]] bool open(const std::string& name, std::size_t size);
+
+    /**
+     * Remove the segment name from the system. Mappings that already exist
+     * remain valid until they are released.
+     */
+    void unlink();
+
+    /**
+     * Remove the segment with the given name, if it still exists
+     * @param name segment name
+     */
+    static void remove(const std::string& name);
+
+    [[nodiscard]] const std::string& name() const;
+
+    [[nodiscard]] std::uint8_t* data() const;
+
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    /**
+     * Initialize pimpl according to platform
+     */
+    void createImpl();
+
+    // pimpl idiom
+    std::shared_ptr<SharedMemoryImpl> impl_{};
+};
+
+} // namespace oid
+
+#endif // SYSTEM_SHARED_MEMORY_H_
@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef SYSTEM_SHARED_MEMORY_IMPL_H_
+#define SYSTEM_SHARED_MEMORY_IMPL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace oid
+{
+
+/**
+ * Interface to platform specific shared memory segments
+ */
+class SharedMemoryImpl
+{
+  public:
+    virtual ~SharedMemoryImpl() noexcept = default;
+
+    /**
+     * Create a new segment with a unique name and map it
+     * @param size segment size, in bytes
+     * @return true on success, false otherwise
+     */
+    virtual bool create(std::size_t size) = 0;
+
+    /**
+     * Map an existing segment
+     * @param name segment name
+     * @param size segment size, in bytes
+     * @return true on success, false otherwise
+     */
+    virtual bool open(const std::string& name, std::size_t size) = 0;
+
+    /**
+     * Remove the segment name from the system
+     */
+    virtual void unlink() = 0;
+
+    [[nodiscard]] const std::string& name() const
+    {
+        return name_;
+    }
+
+    [[nodiscard]] std::uint8_t* data() const
+    {
+        return data_;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return size_;
+    }
+
+  protected:
+    std::string name_{};
+    std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+};
+
+} // namespace oid
+
+#endif // SYSTEM_SHARED_MEMORY_IMPL_H_
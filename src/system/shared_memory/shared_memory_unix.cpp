@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "shared_memory.h"
+#include "shared_memory_impl.h"
+
+#include <atomic>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oid
+{
+
+class SharedMemoryImplUnix final : public SharedMemoryImpl
+{
+  public:
+    SharedMemoryImplUnix() = default;
+
+    SharedMemoryImplUnix(const SharedMemoryImplUnix&) = delete;
+
+    SharedMemoryImplUnix(SharedMemoryImplUnix&&) = delete;
+
+    SharedMemoryImplUnix& operator=(const SharedMemoryImplUnix&) = delete;
+
+    SharedMemoryImplUnix& operator=(SharedMemoryImplUnix&&) = delete;
+
+    ~SharedMemoryImplUnix() noexcept override
+    {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+    }
+
+    bool create(const std::size_t size) override
+    {
+        static auto segment_counter = std::atomic<unsigned>{0};
+
+        if (size == 0) {
+            return false;
+        }
+
+        // Names are kept short since macOS limits them to 31 characters
+        name_ = "/oid-" + std::to_string(getpid()) + "-" +
+                std::to_string(segment_counter++);
+
+        const auto fd = shm_open(
+            name_.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            return false;
+        }
+
+        const auto is_mapped =
+            ftruncate(fd, static_cast<off_t>(size)) == 0 && map(fd, size);
+        close(fd);
+
+        if (!is_mapped) {
+            shm_unlink(name_.c_str());
+        }
+
+        return is_mapped;
+    }
+
+    bool open(const std::string& name, const std::size_t size) override
+    {
+        if (size == 0) {
+            return false;
+        }
+
+        name_ = name;
+
+        const auto fd = shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        // Pages past the end of the segment cannot be accessed
+        struct stat status{};
+        if (fstat(fd, &status) != 0 ||
+            static_cast<std::size_t>(status.st_size) < size) {
+            close(fd);
+            return false;
+        }
+
+        const auto is_mapped = map(fd, size);
+        close(fd);
+
+        return is_mapped;
+    }
+
+    void unlink() override
+    {
+        if (!name_.empty()) {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+  private:
+    bool map(const int fd, const std::size_t size)
+    {
+        const auto address =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+
+        data_ = static_cast<std::uint8_t*>(address);
+        size_ = size;
+
+        return true;
+    }
+};
+
+void SharedMemory::createImpl()
+{
+    impl_ = std::make_shared<SharedMemoryImplUnix>();
+}
+
+void SharedMemory::remove(const std::string& name)
+{
+    shm_unlink(name.c_str());
+}
+
+} // namespace oid
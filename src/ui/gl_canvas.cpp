@@ -25,12 +25,17 @@
 
 #include "gl_canvas.h"
 
+#include <algorithm>
 #include <iostream>
 
+#include <QOpenGLExtraFunctions>
+
 #include "main_window/main_window.h"
 #include "ui/gl_text_renderer.h"
 #include "visualization/components/camera.h"
 #include "visualization/game_object.h"
+#include "visualization/texture_cache.h"
+#include "visualization/texture_uploader.h"
 
 
 namespace oid
@@ -39,6 +44,8 @@ namespace oid
 GLCanvas::GLCanvas(QWidget* parent)
     : QOpenGLWidget{parent}
     , text_renderer_{std::make_unique<GLTextRenderer>(this)}
+    , texture_uploader_{std::make_unique<TextureUploader>()}
+    , texture_cache_{std::make_unique<TextureCache>()}
 {
     mouse_down_[0] = mouse_down_[1] = false;
 }
@@ -140,6 +147,25 @@ void GLCanvas::initializeGL()
     // Initialize text renderer
     text_renderer_->initialize();
 
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size_);
+
+    // Optional features, each core since the version given
+    const auto version = context()->format().version();
+    capabilities_.texture_storage =
+        version >= qMakePair(4, 2) ||
+        context()->hasExtension("GL_ARB_texture_storage");
+    capabilities_.texture_rg = version >= qMakePair(3, 0) ||
+                               context()->hasExtension("GL_ARB_texture_rg");
+    capabilities_.texture_snorm =
+        version >= qMakePair(3, 1) ||
+        context()->hasExtension("GL_EXT_texture_snorm");
+    capabilities_.generate_mipmap =
+        version >= qMakePair(3, 0) ||
+        context()->hasExtension("GL_ARB_framebuffer_object");
+
+    // Start uploading textures in the background, if supported
+    texture_uploader_->initialize(context());
+
     initialized_ = true;
 }
 
@@ -148,6 +174,9 @@ void GLCanvas::paintGL()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     main_window_->draw();
+
+    // Textures drawn in this frame are kept resident
+    texture_cache_->finish_frame();
 }
 
 
@@ -164,6 +193,65 @@ const GLTextRenderer* GLCanvas::get_text_renderer() const
 }
 
 
+TextureUploader* GLCanvas::get_texture_uploader() const
+{
+    return texture_uploader_->is_available() ? texture_uploader_.get()
+                                             : nullptr;
+}
+
+
+TextureCache* GLCanvas::get_texture_cache() const
+{
+    return texture_cache_.get();
+}
+
+
+int GLCanvas::get_max_texture_size() const
+{
+    return max_texture_size_;
+}
+
+
+const GLCapabilities& GLCanvas::get_capabilities() const
+{
+    return capabilities_;
+}
+
+
+void GLCanvas::allocate_texture_storage(const int levels,
+                                        const GLint internal_format,
+                                        const int width,
+                                        const int height,
+                                        const GLenum format,
+                                        const GLenum type)
+{
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+    if (capabilities_.texture_storage) {
+        context()->extraFunctions()->glTexStorage2D(
+            GL_TEXTURE_2D,
+            levels,
+            static_cast<GLenum>(internal_format),
+            width,
+            height);
+        return;
+    }
+
+    // Each level is half the size of the previous one, down to 1x1
+    for (int level = 0; level < levels; ++level) {
+        glTexImage2D(GL_TEXTURE_2D,
+                     level,
+                     internal_format,
+                     (std::max)(width >> level, 1),
+                     (std::max)(height >> level, 1),
+                     0,
+                     format,
+                     type,
+                     nullptr);
+    }
+}
+
+
 void GLCanvas::render_buffer_icon(Stage* stage,
                                   const int icon_width,
                                   const int icon_height)
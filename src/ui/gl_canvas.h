@@ -42,6 +42,20 @@ namespace oid
 class GLTextRenderer;
 class MainWindow;
 class Stage;
+class TextureCache;
+class TextureUploader;
+
+/**
+ * Features of the OpenGL context beyond the 2.1 baseline that the canvas
+ * makes use of when available
+ */
+struct GLCapabilities
+{
+    bool texture_storage{}; // Immutable storage (4.2, ARB_texture_storage)
+    bool texture_rg{};      // R and RG formats (3.0, ARB_texture_rg)
+    bool texture_snorm{};   // Signed normalized formats (3.1)
+    bool generate_mipmap{}; // glGenerateMipmap (3.0, ARB_framebuffer_object)
+};
 
 class GLCanvas final : public QOpenGLWidget, public QOpenGLFunctions
 {
@@ -87,6 +101,36 @@ class GLCanvas final : public QOpenGLWidget, public QOpenGLFunctions
 
     [[nodiscard]] const GLTextRenderer* get_text_renderer() const;
 
+    /**
+     * @return nullptr if textures cannot be uploaded in the background, in
+     *     which case they are filled on the GUI thread
+     */
+    [[nodiscard]] TextureUploader* get_texture_uploader() const;
+
+    [[nodiscard]] TextureCache* get_texture_cache() const;
+
+    /**
+     * Largest width and height of the textures supported by the context
+     */
+    [[nodiscard]] int get_max_texture_size() const;
+
+    /**
+     * Only valid once the canvas is initialized
+     */
+    [[nodiscard]] const GLCapabilities& get_capabilities() const;
+
+    /**
+     * Allocate the storage of the bound 2D texture and its mip levels,
+     * which is immutable if the context supports it. Sampling is limited to
+     * the levels allocated.
+     */
+    void allocate_texture_storage(int levels,
+                                  GLint internal_format,
+                                  int width,
+                                  int height,
+                                  GLenum format,
+                                  GLenum type);
+
     void set_main_window(MainWindow* mw);
 
     void render_buffer_icon(Stage* stage, int icon_width, int icon_height);
@@ -104,7 +148,16 @@ class GLCanvas final : public QOpenGLWidget, public QOpenGLFunctions
 
     bool initialized_{false};
 
+    GLCapabilities capabilities_{};
+
+    // Guaranteed by OpenGL 3.0, until queried
+    GLint max_texture_size_{1024};
+
     std::unique_ptr<GLTextRenderer> text_renderer_{};
+
+    std::unique_ptr<TextureUploader> texture_uploader_{};
+
+    std::unique_ptr<TextureCache> texture_cache_{};
 };
 
 } // namespace oid
@@ -74,8 +74,8 @@ void GoToWidget::keyPressEvent(QKeyEvent* e)
     case Qt::Key_Return:
         toggle_visible();
         e->accept();
-        Q_EMIT(go_to_requested(x_coordinate_->text().toFloat() + 0.5f,
-                               y_coordinate_->text().toFloat() + 0.5f));
+        Q_EMIT(go_to_requested(x_coordinate_->text().toDouble() + 0.5,
+                               y_coordinate_->text().toDouble() + 0.5));
         return; // Let the completer do default behavior
     default:
         return;
@@ -103,11 +103,15 @@ void GoToWidget::toggle_visible()
 }
 
 
-void GoToWidget::set_defaults(const float default_x,
-                              const float default_y) const
+void GoToWidget::set_defaults(const double default_x,
+                              const double default_y) const
 {
-    x_coordinate_->setText(QString::number(std::round(default_x - 0.5f)));
-    y_coordinate_->setText(QString::number(std::round(default_y - 0.5f)));
+    // Formatted as integers, since doubles are shortened to six significant
+    // digits, which is not enough for the columns of gigapixel buffers
+    x_coordinate_->setText(
+        QString::number(static_cast<qlonglong>(std::llround(default_x - 0.5))));
+    y_coordinate_->setText(
+        QString::number(static_cast<qlonglong>(std::llround(default_y - 0.5))));
 }
 
 } // namespace oid
@@ -44,10 +44,10 @@ class GoToWidget final : public QWidget
   public:
     explicit GoToWidget(QWidget* parent = nullptr);
     void toggle_visible();
-    void set_defaults(float default_x, float default_y) const;
+    void set_defaults(double default_x, double default_y) const;
 
   Q_SIGNALS:
-    void go_to_requested(float x, float y);
+    void go_to_requested(double x, double y);
 
   protected:
     void keyPressEvent(QKeyEvent* e) override;
@@ -37,6 +37,7 @@
 #include <QShortcut>
 
 #include "ui_main_window.h"
+#include "visualization/texture_cache.h"
 
 namespace oid
 {
@@ -242,6 +243,17 @@ void MainWindow::initialize_settings()
         render_framerate_ = 1.0;
     }
 
+    // Load texture memory budget, in MiB
+    const auto texture_memory_budget =
+        settings
+            .value("Rendering/texture_memory_budget",
+                   qulonglong{TextureCache::default_budget >> 20})
+            .value<qulonglong>();
+    ui_->bufferPreview->get_texture_cache()->set_budget(
+        static_cast<std::size_t>((std::max)(texture_memory_budget,
+                                            qulonglong{1}))
+        << 20);
+
     // Default save suffix: Image
     settings.beginGroup("Export");
     if (settings.contains("default_export_suffix")) {
@@ -436,17 +448,27 @@ void MainWindow::initialize_shortcuts()
             this,
             SLOT(toggle_go_to_dialog()));
     connect(go_to_widget_.get(),
-            SIGNAL(go_to_requested(float, float)),
+            SIGNAL(go_to_requested(double, double)),
             this,
-            SLOT(go_to_pixel(float, float)));
+            SLOT(go_to_pixel(double, double)));
 }
 
 
 void MainWindow::initialize_networking()
 {
-    socket_.connectToHost(QString(host_settings_.url.c_str()),
-                          host_settings_.port);
-    socket_.waitForConnected();
+    // Messages are handled as soon as they arrive, instead of waiting for the
+    // next tick of the update timer
+    network_thread_ = std::make_unique<NetworkThread>(host_settings_, [this] {
+        if (!is_loop_scheduled_.exchange(true)) {
+            QMetaObject::invokeMethod(
+                this,
+                [this] {
+                    is_loop_scheduled_ = false;
+                    loop();
+                },
+                Qt::QueuedConnection);
+        }
+    });
 }
 
 
@@ -464,6 +486,10 @@ void MainWindow::initialize_symbol_completer()
             SIGNAL(activated(QString)),
             this,
             SLOT(symbol_completed(QString)));
+    connect(ui_->symbolList,
+            SIGNAL(focused()),
+            this,
+            SLOT(request_available_symbols()));
 }
 
 
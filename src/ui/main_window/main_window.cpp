@@ -25,7 +25,10 @@
 
 #include "main_window.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <ranges>
 #include <utility>
 
@@ -38,6 +41,7 @@
 #include "visualization/components/buffer_values.h"
 #include "visualization/components/camera.h"
 #include "visualization/game_object.h"
+#include "visualization/texture_cache.h"
 
 
 Q_DECLARE_METATYPE(QList<QString>)
@@ -71,6 +75,9 @@ MainWindow::MainWindow(ConnectionSettings host_settings, QWidget* parent)
 
 MainWindow::~MainWindow()
 {
+    for (const auto& stage : stages_ | std::views::values) {
+        stage->cancel_texture_upload();
+    }
     held_buffers_.clear();
     is_window_ready_ = false;
 }
@@ -113,7 +120,7 @@ bool MainWindow::is_window_ready() const
 
 void MainWindow::loop()
 {
-    decode_incoming_messages();
+    process_incoming_messages();
 
     if (completer_updated_) {
         // Update auto-complete suggestion list
@@ -121,6 +128,16 @@ void MainWindow::loop()
         completer_updated_ = false;
     }
 
+    // Display the buffers whose textures finished uploading
+    for (const auto& [name, stage] : stages_) {
+        if (stage->collect_texture_upload()) {
+            icons_to_repaint_.insert(name);
+            if (stage.get() == currently_selected_stage_) {
+                request_render_update_ = true;
+            }
+        }
+    }
+
     // Run update for current stage
     if (currently_selected_stage_ != nullptr) {
         currently_selected_stage_->update();
@@ -128,6 +145,8 @@ void MainWindow::loop()
 
     // Update visualization pane
     if (request_render_update_) {
+        request_visible_region();
+
         ui_->bufferPreview->update();
         update_status_bar();
         request_render_update_ = false;
@@ -141,6 +160,30 @@ void MainWindow::loop()
         }
 
         request_icons_update_ = false;
+        icons_to_repaint_.clear();
+    }
+
+    // Update the icons of buffers plotted recently, once their textures are
+    // uploaded
+    std::erase_if(icons_to_repaint_, [this](const std::string& name) {
+        if (const auto stage = stages_.find(name);
+            stage != stages_.end() &&
+            stage->second->is_texture_upload_pending()) {
+            return false;
+        }
+
+        repaint_image_list_icon(name);
+        return true;
+    });
+
+    // Update AC values
+    if (request_ac_labels_update_) {
+        if (currently_selected_stage_ != nullptr) {
+            reset_ac_min_labels();
+            reset_ac_max_labels();
+        }
+
+        request_ac_labels_update_ = false;
     }
 }
 
@@ -202,6 +245,12 @@ void MainWindow::persist_settings()
     // Write maximum framerate
     settings.setValue("Rendering/maximum_framerate", render_framerate_);
 
+    // Write texture memory budget, in MiB
+    const auto texture_memory_budget =
+        ui_->bufferPreview->get_texture_cache()->get_budget() >> 20;
+    settings.setValue("Rendering/texture_memory_budget",
+                      qulonglong{texture_memory_budget});
+
     // Write previous session symbols
     settings.setValue("PreviousSession/buffers",
                       QVariant::fromValue(persisted_session_buffers));
@@ -256,15 +305,80 @@ vec4 MainWindow::get_stage_coordinates(const float pos_window_x,
     const auto vp_inv        = (cam->projection * view * buff_pose).inv();
 
     auto mouse_pos = vp_inv * mouse_pos_ndc;
-    mouse_pos += vec4(buffer->buffer_width_f / 2.0f,
-                      buffer->buffer_height_f / 2.f,
-                      0.0f,
-                      0.0f);
+    mouse_pos += vec4(static_cast<double>(buffer->full_width) / 2.0,
+                      static_cast<double>(buffer->full_height) / 2.0,
+                      0.0,
+                      0.0);
 
     return mouse_pos;
 }
 
 
+std::optional<BufferRegion>
+MainWindow::get_visible_region(const BufferMetadata& metadata) const
+{
+    const auto cam_obj = currently_selected_stage_->get_game_object("camera");
+    const auto cam     = cam_obj->get_component<Camera>("camera_component");
+
+    const auto win_w = static_cast<float>(ui_->bufferPreview->width());
+    const auto win_h = static_cast<float>(ui_->bufferPreview->height());
+
+    // The view may be rotated, so its bounds are taken from all its corners
+    auto lower = vec4{std::numeric_limits<double>::max(),
+                      std::numeric_limits<double>::max(),
+                      0.0,
+                      1.0};
+    auto upper = vec4{std::numeric_limits<double>::lowest(),
+                      std::numeric_limits<double>::lowest(),
+                      0.0,
+                      1.0};
+    for (const auto& [corner_x, corner_y] :
+         {std::pair{0.0f, 0.0f},
+          std::pair{win_w, 0.0f},
+          std::pair{0.0f, win_h},
+          std::pair{win_w, win_h}}) {
+        const auto corner = get_stage_coordinates(corner_x, corner_y);
+        lower.x()         = (std::min)(lower.x(), corner.x());
+        lower.y()         = (std::min)(lower.y(), corner.y());
+        upper.x()         = (std::max)(upper.x(), corner.x());
+        upper.y()         = (std::max)(upper.y(), corner.y());
+    }
+
+    // Sample no more pixels than the screen can show
+    auto downsampling = 1;
+    while (static_cast<float>(downsampling * 2) * cam->compute_zoom() <= 1.0f) {
+        downsampling *= 2;
+    }
+
+    // Snap the bounds to a grid of region_alignment sampled pixels
+    const auto grid    = region_alignment * downsampling;
+    const auto to_grid = [&](const double coordinate, const std::int64_t size) {
+        return std::clamp(coordinate, 0.0, static_cast<double>(size)) /
+               static_cast<double>(grid);
+    };
+    const auto from_grid = [&](const double cell, const std::int64_t size) {
+        return (std::min)(static_cast<std::int64_t>(cell) * grid, size);
+    };
+
+    const auto& [width, height] = std::pair{metadata.width, metadata.height};
+
+    const auto x0 = from_grid(std::floor(to_grid(lower.x(), width)), width);
+    const auto y0 = from_grid(std::floor(to_grid(lower.y(), height)), height);
+    const auto x1 = from_grid(std::ceil(to_grid(upper.x(), width)), width);
+    const auto y1 = from_grid(std::ceil(to_grid(upper.y(), height)), height);
+
+    if (x1 <= x0 || y1 <= y0) {
+        return std::nullopt;
+    }
+
+    return BufferRegion{.x            = x0,
+                        .y            = y0,
+                        .width        = x1 - x0,
+                        .height       = y1 - y0,
+                        .downsampling = downsampling};
+}
+
+
 void MainWindow::update_status_bar() const
 {
     if (currently_selected_stage_ != nullptr) {
@@ -288,18 +402,18 @@ void MainWindow::update_status_bar() const
         // Position
         const auto mouse_pos = get_stage_coordinates(mouse_x, mouse_y);
 
+        const auto pixel_x = static_cast<std::int64_t>(floor(mouse_pos.x()));
+        const auto pixel_y = static_cast<std::int64_t>(floor(mouse_pos.y()));
+
         // Zoom
-        message << std::fixed << std::setprecision(3) << "("
-                << static_cast<int>(floor(mouse_pos.x())) << ", "
-                << static_cast<int>(floor(mouse_pos.y())) << ")\t"
-                << cam->compute_zoom() * 100.0f << "%";
+        message << std::fixed << std::setprecision(3) << "(" << pixel_x
+                << ", " << pixel_y << ")\t" << cam->compute_zoom() * 100.0f
+                << "%";
 
         // Value
         message << " val=";
 
-        buffer->get_pixel_info(message,
-                               static_cast<int>(floor(mouse_pos.x())),
-                               static_cast<int>(floor(mouse_pos.y())));
+        buffer->get_pixel_info(message, pixel_x, pixel_y);
 
         // Float precision
         if (BufferType::Float64 == buffer->type ||
@@ -26,19 +26,23 @@
 #ifndef MAIN_WINDOW_H_
 #define MAIN_WINDOW_H_
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <QLabel>
 #include <QSettings>
-#include <QTcpSocket>
 #include <QTimer>
 
+#include "ipc/message_exchange.h"
 #include "math/linear_algebra.h"
 #include "ui/go_to_widget.h"
+#include "ui/network_thread.h"
 #include "ui/symbol_completer.h"
 #include "ui_main_window.h"
 #include "visualization/stage.h"
@@ -47,13 +51,6 @@
 namespace oid
 {
 
-struct ConnectionSettings
-{
-    std::string url{};
-    uint16_t port{};
-};
-
-
 class MainWindow final : public QMainWindow
 {
     Q_OBJECT
@@ -167,7 +164,12 @@ class MainWindow final : public QMainWindow
 
     void toggle_go_to_dialog() const;
 
-    void go_to_pixel(float x, float y);
+    void go_to_pixel(double x, double y);
+
+    ///
+    // Communication with debugger bridge - slots - implemented in
+    // message_processing.cpp
+    void request_available_symbols();
 
   private Q_SLOTS:
     ///
@@ -178,6 +180,7 @@ class MainWindow final : public QMainWindow
     bool is_window_ready_{true};
     bool request_render_update_{true};
     bool request_icons_update_{true};
+    bool request_ac_labels_update_{false};
     bool completer_updated_{false};
     bool ac_enabled_{false};
     bool link_views_enabled_{false};
@@ -190,19 +193,43 @@ class MainWindow final : public QMainWindow
     QTimer settings_persist_timer_{};
     QTimer update_timer_{};
 
+    // Set while a loop() iteration requested by the network thread is queued
+    std::atomic<bool> is_loop_scheduled_{false};
+
     QString default_export_suffix_{};
 
     Stage* currently_selected_stage_{nullptr};
 
-    std::map<std::string, std::vector<uint8_t>, std::less<>> held_buffers_{};
+    std::map<std::string, HeldBuffer, std::less<>> held_buffers_{};
     std::map<std::string, std::shared_ptr<Stage>, std::less<>> stages_{};
 
+    // Buffers too large to be sent whole. The bridge sends an overview when
+    // they are plotted, and the window requests the regions it displays.
+    struct OnDemandBuffer
+    {
+        BufferMetadata metadata{};
+        std::optional<BufferRegion> displayed_region{};
+        std::optional<BufferRegion> requested_region{};
+
+        // Regions displayed before, most recent first
+        std::deque<std::pair<BufferRegion, HeldBuffer>> cached_regions{};
+    };
+    std::map<std::string, OnDemandBuffer, std::less<>> on_demand_buffers_{};
+
+    // Requested regions are aligned to this many sampled pixels, so that small
+    // camera movements are served by regions that were already received
+    static constexpr int region_alignment           = 256;
+    static constexpr std::size_t max_cached_regions = 8;
+
     std::set<std::string, std::less<>> previous_session_buffers_{};
+
+    // Buffers plotted since the last loop iteration, whose icons are repainted
+    // once no matter how many updates they received
+    std::set<std::string, std::less<>> icons_to_repaint_{};
     std::set<std::string, std::less<>> removed_buffer_names_{};
 
     QStringList available_vars_{};
 
-    std::mutex ui_mutex_{};
 
     std::unique_ptr<SymbolCompleter> symbol_completer_{};
 
@@ -212,7 +239,7 @@ class MainWindow final : public QMainWindow
     std::unique_ptr<GoToWidget> go_to_widget_{};
 
     ConnectionSettings host_settings_{};
-    QTcpSocket socket_{};
+    std::unique_ptr<NetworkThread> network_thread_{};
 
     QString name_channel_1_{"red"};
     QString name_channel_2_{"green"};
@@ -234,6 +261,13 @@ class MainWindow final : public QMainWindow
     [[nodiscard]] vec4 get_stage_coordinates(float pos_window_x,
                                              float pos_window_y) const;
 
+    /**
+     * Region of a buffer required to display the current view of the selected
+     * stage, sampled according to the zoom level
+     */
+    [[nodiscard]] std::optional<BufferRegion>
+    get_visible_region(const BufferMetadata& metadata) const;
+
     ///
     // Assorted methods - private - implemented in ui_events.cpp
     void propagate_key_press_event(const QKeyEvent* key_event,
@@ -241,7 +275,13 @@ class MainWindow final : public QMainWindow
 
     ///
     // Communication with debugger bridge
-    void decode_set_available_symbols();
+    void set_available_symbols(const QStringList& symbols);
+
+    void update_available_symbols(const AvailableSymbolsUpdateMessage& message);
+
+    void available_symbols_changed();
+
+    [[nodiscard]] bool has_unrestored_session_buffers() const;
 
     void respond_get_observed_symbols();
 
@@ -253,12 +293,30 @@ class MainWindow final : public QMainWindow
     void update_image_list_label(const std::string& variable_name_str,
                                  const std::string& label_str) const;
 
-    void decode_plot_buffer_contents();
+    void plot_buffer(const BufferMetadata& metadata,
+                     HeldBuffer held_buffer,
+                     const std::optional<BufferRegion>& region);
+
+    void plot_buffer_region(PlotBufferMessage& message);
+
+    void display_buffer_region(OnDemandBuffer& on_demand_buffer,
+                               HeldBuffer held_buffer,
+                               const BufferRegion& region);
 
-    void decode_incoming_messages();
+    void request_visible_region();
+
+    void patch_buffer_tiles(PlotBufferTilesMessage& message);
+
+    void apply_plot_message(PlotBufferMessage& message);
+
+    void confirm_buffer_unchanged(const PlotBufferUnchangedMessage& message);
+
+    void process_incoming_messages();
 
     void request_plot_buffer(const char* buffer_name);
 
+    void request_plot_buffers(const std::deque<std::string>& buffer_names);
+
     ///
     // Auto contrast pane - private - implemented in auto_contrast.cpp
     void set_ac_min_value(int idx, float value);
@@ -26,42 +26,109 @@
 #include "ipc/message_exchange.h"
 #include "main_window.h"
 
-#include <bit>
+#include <algorithm>
+#include <cstring>
+
 #include <iostream>
 #include <memory>
 #include <ranges>
+#include <utility>
+#include <variant>
 
 #include "ui_main_window.h"
 
 namespace oid
 {
 
-void MainWindow::decode_set_available_symbols()
+
+void MainWindow::set_available_symbols(const QStringList& symbols)
+{
+    available_vars_ = symbols;
+    available_symbols_changed();
+}
+
+
+void MainWindow::update_available_symbols(
+    const AvailableSymbolsUpdateMessage& message)
 {
-    const auto lock      = std::unique_lock{ui_mutex_};
-    auto message_decoder = MessageDecoder{&socket_};
-    message_decoder.read<QStringList, QString>(available_vars_);
+    for (const auto& symbol : message.removed_symbols) {
+        available_vars_.removeOne(symbol);
+    }
+    available_vars_.append(message.added_symbols);
+
+    // Shallow members come first, then symbols are sorted by name
+    std::sort(available_vars_.begin(),
+              available_vars_.end(),
+              [](const QString& lhs, const QString& rhs) {
+                  const auto lhs_depth = lhs.count('.');
+                  const auto rhs_depth = rhs.count('.');
+                  return lhs_depth != rhs_depth ? lhs_depth < rhs_depth
+                                                : lhs < rhs;
+              });
+
+    available_symbols_changed();
+}
+
 
+void MainWindow::available_symbols_changed()
+{
+    // Plot buffers that were available in the previous session, all at once
+    auto previous_session_symbols = std::deque<std::string>{};
     for (const auto& symbol_value : available_vars_) {
-        // Plot buffer if it was available in the previous session
-        if (previous_session_buffers_.contains(symbol_value.toStdString())) {
-            request_plot_buffer(symbol_value.toStdString().data());
+        if (auto symbol_str = symbol_value.toStdString();
+            previous_session_buffers_.contains(symbol_str) &&
+            !held_buffers_.contains(symbol_str)) {
+            previous_session_symbols.push_back(std::move(symbol_str));
         }
     }
 
+    if (!previous_session_symbols.empty()) {
+        request_plot_buffers(previous_session_symbols);
+    }
+
     completer_updated_ = true;
 }
 
 
+bool MainWindow::has_unrestored_session_buffers() const
+{
+    return std::ranges::any_of(
+        previous_session_buffers_, [this](const std::string& name) {
+            return !held_buffers_.contains(name) &&
+                   !removed_buffer_names_.contains(name);
+        });
+}
+
+
+void MainWindow::request_available_symbols()
+{
+    auto message_composer = MessageComposer{};
+    message_composer.push(MessageType::AvailableSymbolsRequest);
+    network_thread_->send(std::move(message_composer));
+}
+
+
 void MainWindow::respond_get_observed_symbols()
 {
     auto message_composer = MessageComposer{};
     message_composer.push(MessageType::GetObservedSymbolsResponse)
         .push(held_buffers_.size());
+
+    // The selected buffer goes first, so that it is plotted ahead of the
+    // others when the debugger stops
+    auto selected_name = std::string{};
+    if (const auto* item = ui_->imageList->currentItem(); item != nullptr) {
+        selected_name = item->data(Qt::UserRole).toString().toStdString();
+    }
+    if (held_buffers_.contains(selected_name)) {
+        message_composer.push(selected_name);
+    }
     for (const auto& name : held_buffers_ | std::views::keys) {
-        message_composer.push(name);
+        if (name != selected_name) {
+            message_composer.push(name);
+        }
     }
-    message_composer.send(&socket_);
+    network_thread_->send(std::move(message_composer));
 }
 
 
@@ -126,44 +193,79 @@ void MainWindow::update_image_list_label(const std::string& variable_name_str,
 }
 
 
-void MainWindow::decode_plot_buffer_contents()
+void MainWindow::patch_buffer_tiles(PlotBufferTilesMessage& message)
 {
-    // Read buffer info
-    auto variable_name_str = std::string{};
-    auto display_name_str  = std::string{};
-    auto pixel_layout_str  = std::string{};
-    auto transpose_buffer  = bool{};
-    auto buff_width        = int{};
-    auto buff_height       = int{};
-    auto buff_channels     = int{};
-    auto buff_stride       = int{};
-    auto buff_type         = BufferType{};
-    auto buff_contents     = std::vector<std::uint8_t>{};
-
-    auto message_decoder = MessageDecoder{&socket_};
-    message_decoder.read(variable_name_str)
-        .read(display_name_str)
-        .read(pixel_layout_str)
-        .read(transpose_buffer)
-        .read(buff_width)
-        .read(buff_height)
-        .read(buff_channels)
-        .read(buff_stride)
-        .read(buff_type)
-        .read(buff_contents);
+    // Tiles can only be patched into the buffer they were computed against
+    const auto held_buffer = held_buffers_.find(message.metadata.variable_name);
+    if (!message.is_complete || held_buffer == held_buffers_.end() ||
+        held_buffer->second.size != message.held_size) {
+        // The bridge forgets what it sent when a buffer is requested, so the
+        // next plot will carry the whole buffer
+        request_plot_buffer(message.metadata.variable_name.c_str());
+        return;
+    }
 
-    // Put the data buffer into the container
-    if (buff_type == BufferType::Float64) {
-        held_buffers_[variable_name_str] =
-            make_float_buffer_from_double(buff_contents);
-    } else {
-        held_buffers_[variable_name_str] = std::move(buff_contents);
+    // Uploads must be done reading the contents before they are patched
+    if (const auto stage = stages_.find(message.metadata.variable_name);
+        stage != stages_.end()) {
+        stage->second->cancel_texture_upload();
     }
-    const auto buff_ptr = held_buffers_[variable_name_str].data();
+
+    for (const auto& tile : message.tiles) {
+        std::memcpy(
+            held_buffer->second.data + tile.offset, tile.data, tile.size);
+    }
+
+    auto patched_buffer = std::move(held_buffer->second);
+    plot_buffer(message.metadata, std::move(patched_buffer), std::nullopt);
+}
+
+
+void MainWindow::confirm_buffer_unchanged(
+    const PlotBufferUnchangedMessage& message)
+{
+    // The buffer may have been removed since it was last plotted, in which
+    // case the bridge is asked for its whole contents
+    if (!held_buffers_.contains(message.variable_name)) {
+        request_plot_buffer(message.variable_name.c_str());
+    }
+}
+
+
+void MainWindow::plot_buffer(const BufferMetadata& metadata,
+                             HeldBuffer held_buffer,
+                             const std::optional<BufferRegion>& region)
+{
+    const auto& variable_name_str = metadata.variable_name;
+    const auto& display_name_str  = metadata.display_name;
+    const auto& pixel_layout_str  = metadata.pixel_layout;
+    const auto transpose_buffer   = metadata.transpose;
+    const auto buff_width         = metadata.width;
+    const auto buff_height        = metadata.height;
+    const auto buff_channels      = metadata.channels;
+    const auto buff_stride        = metadata.stride;
+    const auto buff_type          = metadata.type;
+
+    // Previews and regions hold tightly packed rows
+    const auto displayed_region = region.value_or(
+        BufferRegion{.width = buff_width, .height = buff_height});
+    const auto held_stride =
+        region.has_value() ? region->sampled_width() : buff_stride;
+
+    // Uploads must be done reading the contents before they are replaced
+    if (const auto stage = stages_.find(variable_name_str);
+        stage != stages_.end()) {
+        stage->second->cancel_texture_upload();
+    }
+
+    // Put the data buffer into the container
+    auto& held_buffer_entry = held_buffers_[variable_name_str];
+    held_buffer_entry       = std::move(held_buffer);
+    const auto buff_ptr     = held_buffer_entry.data;
 
     // Human readable dimensions
-    auto visualized_width  = int{};
-    auto visualized_height = int{};
+    auto visualized_width  = std::int64_t{};
+    auto visualized_height = std::int64_t{};
     if (!transpose_buffer) {
         visualized_width  = buff_width;
         visualized_height = buff_height;
@@ -192,9 +294,10 @@ void MainWindow::decode_plot_buffer_contents()
                                buff_height,
                                buff_channels,
                                buff_type,
-                               buff_stride,
+                               held_stride,
                                pixel_layout_str,
-                               transpose_buffer)) {
+                               transpose_buffer,
+                               displayed_region)) {
             std::cerr << "[error] Could not initialize opengl canvas!"
                       << std::endl;
         }
@@ -208,9 +311,10 @@ void MainWindow::decode_plot_buffer_contents()
                                             buff_height,
                                             buff_channels,
                                             buff_type,
-                                            buff_stride,
+                                            held_stride,
                                             pixel_layout_str,
-                                            transpose_buffer);
+                                            transpose_buffer,
+                                            displayed_region);
     }
 
     // Construct a new list widget if needed
@@ -224,15 +328,11 @@ void MainWindow::decode_plot_buffer_contents()
         ui_->imageList->addItem(item);
     }
 
-    // Update icon and text of corresponding item in image list
-    repaint_image_list_icon(variable_name_str);
+    // Update text of corresponding item in image list. Its icon and the AC
+    // values are updated once all messages of this iteration were applied.
     update_image_list_label(variable_name_str, label_str);
-
-    // Update AC values
-    if (currently_selected_stage_ != nullptr) {
-        reset_ac_min_labels();
-        reset_ac_max_labels();
-    }
+    icons_to_repaint_.insert(variable_name_str);
+    request_ac_labels_update_ = true;
 
     // Update list of observed symbols in settings
     persist_settings_deferred();
@@ -241,40 +341,175 @@ void MainWindow::decode_plot_buffer_contents()
 }
 
 
-void MainWindow::decode_incoming_messages()
+void MainWindow::process_incoming_messages()
 {
     // Close application if server has disconnected
-    if (socket_.state() == QTcpSocket::UnconnectedState) {
+    if (!network_thread_->is_connected()) {
         QApplication::quit();
     }
 
-    available_vars_.clear();
+    // Messages arrive fully decoded from the network thread. At most one
+    // buffer, or one batch of buffers, is plotted per loop iteration, so that
+    // texture uploads are spread across frames.
+    auto is_buffer_plotted = false;
+    while (!is_buffer_plotted) {
+        auto message = network_thread_->try_receive();
+        if (!message.has_value()) {
+            break;
+        }
+
+        if (auto* symbols = std::get_if<AvailableSymbolsMessage>(&*message)) {
+            set_available_symbols(symbols->symbols);
+        } else if (const auto* update =
+                       std::get_if<AvailableSymbolsUpdateMessage>(&*message)) {
+            update_available_symbols(*update);
+        } else if (std::holds_alternative<ObservedSymbolsRequest>(*message)) {
+            respond_get_observed_symbols();
+
+            // The debugger stopped. Symbols are only looked up again if they
+            // are being searched or may restore the previous session.
+            if (ui_->symbolList->hasFocus() ||
+                has_unrestored_session_buffers()) {
+                request_available_symbols();
+            }
+        } else if (auto* plot = std::get_if<PlotBufferMessage>(&*message)) {
+            apply_plot_message(*plot);
+            is_buffer_plotted = true;
+        } else if (auto* tiles =
+                       std::get_if<PlotBufferTilesMessage>(&*message)) {
+            patch_buffer_tiles(*tiles);
+            is_buffer_plotted = true;
+        } else if (const auto* unchanged =
+                       std::get_if<PlotBufferUnchangedMessage>(&*message)) {
+            // Nothing is uploaded, so more messages can be handled
+            confirm_buffer_unchanged(*unchanged);
+        } else if (auto* batch =
+                       std::get_if<PlotBufferBatchMessage>(&*message)) {
+            // Buffers plotted together are displayed in the same iteration
+            for (auto& batch_plot : batch->plots) {
+                if (auto* batch_buffer =
+                        std::get_if<PlotBufferMessage>(&batch_plot)) {
+                    apply_plot_message(*batch_buffer);
+                } else if (auto* batch_tiles =
+                               std::get_if<PlotBufferTilesMessage>(
+                                   &batch_plot)) {
+                    patch_buffer_tiles(*batch_tiles);
+                } else {
+                    confirm_buffer_unchanged(
+                        std::get<PlotBufferUnchangedMessage>(batch_plot));
+                }
+            }
+            is_buffer_plotted = true;
+        }
+    }
+}
+
 
-    if (socket_.bytesAvailable() == 0) {
+void MainWindow::apply_plot_message(PlotBufferMessage& message)
+{
+    if (message.is_on_demand) {
+        plot_buffer_region(message);
         return;
     }
 
-    auto header = MessageType{};
-    if (!socket_.read(std::bit_cast<char*>(&header),
-                      static_cast<qint64>(sizeof(header)))) {
+    on_demand_buffers_.erase(message.metadata.variable_name);
+    plot_buffer(
+        message.metadata, std::move(message.held_buffer), message.region);
+}
+
+
+void MainWindow::plot_buffer_region(PlotBufferMessage& message)
+{
+    const auto& metadata = message.metadata;
+    const auto& region   = *message.region;
+
+    auto& on_demand_buffer = on_demand_buffers_[metadata.variable_name];
+
+    // The bridge sends the whole buffer each time the debugger plots it, which
+    // makes the regions received before stale
+    const auto is_whole_buffer =
+        region.width == metadata.width && region.height == metadata.height;
+    if (is_whole_buffer || on_demand_buffer.metadata != metadata) {
+        on_demand_buffer = OnDemandBuffer{.metadata = metadata};
+    }
+
+    display_buffer_region(
+        on_demand_buffer, std::move(message.held_buffer), region);
+}
+
+
+void MainWindow::display_buffer_region(OnDemandBuffer& on_demand_buffer,
+                                       HeldBuffer held_buffer,
+                                       const BufferRegion& region)
+{
+    const auto& metadata = on_demand_buffer.metadata;
+
+    // Keep the region being replaced, in case the view goes back to it
+    if (const auto displayed = held_buffers_.find(metadata.variable_name);
+        on_demand_buffer.displayed_region.has_value() &&
+        displayed != held_buffers_.end()) {
+        auto& cached_regions = on_demand_buffer.cached_regions;
+        cached_regions.emplace_front(*on_demand_buffer.displayed_region,
+                                     std::move(displayed->second));
+        if (cached_regions.size() > max_cached_regions) {
+            cached_regions.pop_back();
+        }
+    }
+
+    on_demand_buffer.displayed_region = region;
+
+    plot_buffer(metadata, std::move(held_buffer), region);
+}
+
+
+void MainWindow::request_visible_region()
+{
+    if (currently_selected_stage_ == nullptr) {
+        return;
+    }
+
+    const auto on_demand_buffer =
+        std::ranges::find_if(on_demand_buffers_, [&](const auto& entry) {
+            const auto stage = stages_.find(entry.first);
+            return stage != stages_.end() &&
+                   stage->second.get() == currently_selected_stage_;
+        });
+    if (on_demand_buffer == on_demand_buffers_.end()) {
+        return;
+    }
+
+    auto& [name, buffer] = *on_demand_buffer;
+
+    const auto visible_region = get_visible_region(buffer.metadata);
+    if (!visible_region.has_value() ||
+        (buffer.displayed_region.has_value() &&
+         buffer.displayed_region->contains(*visible_region))) {
         return;
     }
 
-    socket_.waitForReadyRead(100);
-
-    switch (header) {
-    case MessageType::SetAvailableSymbols:
-        decode_set_available_symbols();
-        break;
-    case MessageType::GetObservedSymbols:
-        respond_get_observed_symbols();
-        break;
-    case MessageType::PlotBufferContents:
-        decode_plot_buffer_contents();
-        break;
-    default:
-        break;
+    // Regions received before are displayed right away
+    if (const auto cached_region = std::ranges::find_if(
+            buffer.cached_regions,
+            [&](const auto& cached) {
+                return cached.first.contains(*visible_region);
+            });
+        cached_region != buffer.cached_regions.end()) {
+        auto [region, held_buffer] = std::move(*cached_region);
+        buffer.cached_regions.erase(cached_region);
+        display_buffer_region(buffer, std::move(held_buffer), region);
+        return;
+    }
+
+    if (buffer.requested_region == visible_region) {
+        return;
     }
+    buffer.requested_region = visible_region;
+
+    auto message_composer = MessageComposer{};
+    message_composer.push(MessageType::PlotBufferRegionRequest)
+        .push(name)
+        .push(*visible_region);
+    network_thread_->send(std::move(message_composer));
 }
 
 
@@ -282,8 +517,18 @@ void MainWindow::request_plot_buffer(const char* buffer_name)
 {
     auto message_composer = MessageComposer{};
     message_composer.push(MessageType::PlotBufferRequest)
-        .push(std::string(buffer_name))
-        .send(&socket_);
+        .push(std::string(buffer_name));
+    network_thread_->send(std::move(message_composer));
+}
+
+
+void MainWindow::request_plot_buffers(
+    const std::deque<std::string>& buffer_names)
+{
+    auto message_composer = MessageComposer{};
+    message_composer.push(MessageType::PlotBufferBatchRequest)
+        .push(buffer_names);
+    network_thread_->send(std::move(message_composer));
 }
 
 } // namespace oid
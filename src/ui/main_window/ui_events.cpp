@@ -326,6 +326,7 @@ void MainWindow::remove_selected_buffer()
             removed_item->data(Qt::UserRole).toString().toStdString();
         stages_.erase(buffer_name);
         held_buffers_.erase(buffer_name);
+        on_demand_buffers_.erase(buffer_name);
         removed_item.reset();
 
         removed_buffer_names_.insert(buffer_name);
@@ -446,7 +447,7 @@ void MainWindow::show_context_menu(const QPoint& pos)
 void MainWindow::toggle_go_to_dialog() const
 {
     if (!go_to_widget_->isVisible()) {
-        auto default_goal = vec4{0.0f, 0.0f, 0.0f, 0.0f};
+        auto default_goal = vec4{0.0, 0.0, 0.0, 0.0};
 
         if (currently_selected_stage_ != nullptr) {
             const auto cam_obj =
@@ -463,7 +464,7 @@ void MainWindow::toggle_go_to_dialog() const
 }
 
 
-void MainWindow::go_to_pixel(const float x, const float y)
+void MainWindow::go_to_pixel(const double x, const double y)
 {
     if (link_views_enabled_) {
         for (const auto& stage : stages_ | std::views::values) {
@@ -0,0 +1,605 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "network_thread.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#if defined(Q_OS_UNIX)
+#include <poll.h>
+#endif
+
+#include <QTcpSocket>
+
+
+namespace oid
+{
+
+namespace
+{
+
+// Only used where the wakeup notifier has no descriptor to wait upon
+constexpr auto poll_interval_msecs = 5;
+
+} // namespace
+
+
+NetworkThread::NetworkThread(ConnectionSettings host_settings,
+                             std::function<void()> on_message_received)
+    : host_settings_{std::move(host_settings)}
+    , on_message_received_{std::move(on_message_received)}
+    , thread_{&NetworkThread::run, this}
+{
+}
+
+
+NetworkThread::~NetworkThread()
+{
+    is_stop_requested_ = true;
+    wakeup_notifier_.notify();
+    thread_.join();
+}
+
+
+std::optional<IncomingMessage> NetworkThread::try_receive()
+{
+    auto message = incoming_messages_.try_pop();
+    if (message.has_value()) {
+        // The network thread may be waiting for room to hand a message over
+        wakeup_notifier_.notify();
+    }
+
+    return message;
+}
+
+
+void NetworkThread::send(MessageComposer&& message)
+{
+    {
+        auto lock = std::unique_lock{outgoing_mutex_};
+        outgoing_dequeued_.wait(lock, [&] {
+            return !is_connected() ||
+                   outgoing_messages_.try_push(std::move(message));
+        });
+    }
+
+    wakeup_notifier_.notify();
+}
+
+
+bool NetworkThread::is_connected() const
+{
+    return is_connected_;
+}
+
+
+void NetworkThread::run()
+{
+    // The socket is created here so that it belongs to this thread, which uses
+    // its blocking API instead of an event loop
+    auto socket = QTcpSocket{};
+    socket.connectToHost(QString(host_settings_.url.c_str()),
+                         host_settings_.port);
+    if (!socket.waitForConnected()) {
+        is_connected_ = false;
+        notify_outgoing_dequeued();
+        return;
+    }
+
+    // Messages are written as whole frames, so there is nothing to coalesce
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    // Let the bridge know which payload codecs can be decoded here. A frame
+    // that was only partly written leaves the bridge unable to tell where
+    // the next one starts, so the connection is dropped instead.
+    auto capabilities = MessageComposer{};
+    if (!capabilities.push(MessageType::WindowCapabilities)
+             .push(std::size_t{1})
+             .push(PayloadCodec::ShuffleLz)
+             .send(&socket)) {
+        socket.abort();
+    }
+
+    auto frame_assembler = FrameAssembler{};
+
+    // Message that could not be handed over because the queue was full. No
+    // more frames are read until it is, so that a busy GUI slows the bridge
+    // down through TCP flow control.
+    auto pending_message = IncomingMessage{};
+
+    while (!is_stop_requested_ &&
+           socket.state() != QTcpSocket::UnconnectedState) {
+        // Cleared before the queues are looked at, so that a notification
+        // sent after that is not lost
+        wakeup_notifier_.clear();
+
+        auto is_dequeued = false;
+        while (auto message = outgoing_messages_.try_pop()) {
+            is_dequeued = true;
+            if (!message->send(&socket)) {
+                socket.abort();
+                break;
+            }
+        }
+        if (is_dequeued) {
+            notify_outgoing_dequeued();
+        }
+
+        if (std::holds_alternative<std::monostate>(pending_message)) {
+            auto frame = MessageFrame{};
+            if (frame_assembler.receive(&socket, frame)) {
+                pending_message = receive_message(frame);
+            } else {
+                wait_for_activity(socket, true);
+            }
+            continue;
+        }
+
+        if (incoming_messages_.try_push(std::move(pending_message))) {
+            pending_message = std::monostate{};
+            on_message_received_();
+        } else {
+            wait_for_activity(socket, false);
+        }
+    }
+
+    is_connected_ = false;
+    notify_outgoing_dequeued();
+}
+
+
+void NetworkThread::wait_for_activity(QTcpSocket& socket,
+                                      const bool is_reading)
+{
+#if defined(Q_OS_UNIX)
+    if (const auto wakeup_descriptor = wakeup_notifier_.descriptor();
+        wakeup_descriptor >= 0) {
+        // Negative descriptors are ignored by poll()
+        const auto socket_descriptor =
+            is_reading ? static_cast<int>(socket.socketDescriptor()) : -1;
+        auto descriptors = std::array<pollfd, 2>{
+            pollfd{.fd = wakeup_descriptor, .events = POLLIN, .revents = 0},
+            pollfd{.fd = socket_descriptor, .events = POLLIN, .revents = 0}};
+        if (poll(descriptors.data(), descriptors.size(), -1) > 0 &&
+            descriptors[1].revents != 0) {
+            // Move the bytes into the socket buffer, which also notices if
+            // the connection was closed
+            socket.waitForReadyRead(0);
+        }
+        return;
+    }
+#endif
+
+    if (is_reading) {
+        socket.waitForReadyRead(poll_interval_msecs);
+    } else {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds{poll_interval_msecs});
+    }
+}
+
+
+void NetworkThread::notify_outgoing_dequeued()
+{
+    // Taking the lock orders the notification after a concurrent check of
+    // the queue in send()
+    {
+        const auto lock = std::scoped_lock{outgoing_mutex_};
+    }
+    outgoing_dequeued_.notify_all();
+}
+
+
+IncomingMessage NetworkThread::receive_message(MessageFrame& frame)
+{
+    // A batch header announces how many plot frames follow it
+    if (auto header_decoder = MessageDecoder{frame};
+        pending_batch_size_ == 0) {
+        auto header = MessageType{};
+        header_decoder.read(header);
+
+        if (header == MessageType::PlotBufferBatch) {
+            header_decoder.read(pending_batch_size_);
+            return std::monostate{};
+        }
+    }
+
+    auto message = decode_message(frame);
+    if (pending_batch_size_ == 0) {
+        return message;
+    }
+
+    if (auto* plot = std::get_if<PlotBufferMessage>(&message)) {
+        pending_batch_.plots.emplace_back(std::move(*plot));
+    } else if (auto* tiles = std::get_if<PlotBufferTilesMessage>(&message)) {
+        pending_batch_.plots.emplace_back(std::move(*tiles));
+    } else if (auto* unchanged =
+                   std::get_if<PlotBufferUnchangedMessage>(&message)) {
+        pending_batch_.plots.emplace_back(std::move(*unchanged));
+    } else if (!std::holds_alternative<std::monostate>(message)) {
+        // Other messages are not part of the batch
+        return message;
+    }
+
+    // Frames that could not be decoded still count towards the batch size
+    if (--pending_batch_size_ > 0) {
+        return std::monostate{};
+    }
+
+    return std::exchange(pending_batch_, PlotBufferBatchMessage{});
+}
+
+
+IncomingMessage NetworkThread::decode_message(MessageFrame& frame)
+{
+    auto header          = MessageType{};
+    auto message_decoder = MessageDecoder{frame};
+    message_decoder.read(header);
+
+    switch (header) {
+    case MessageType::SetAvailableSymbols: {
+        auto message = AvailableSymbolsMessage{};
+        message_decoder.read<QStringList, QString>(message.symbols);
+        return message;
+    }
+    case MessageType::UpdateAvailableSymbols: {
+        auto message = AvailableSymbolsUpdateMessage{};
+        message_decoder.read<QStringList, QString>(message.added_symbols)
+            .read<QStringList, QString>(message.removed_symbols);
+        return message;
+    }
+    case MessageType::GetObservedSymbols:
+        return ObservedSymbolsRequest{};
+    case MessageType::PlotBufferContents:
+        return decode_plot_buffer_contents(message_decoder, frame);
+    case MessageType::PlotBufferSharedContents:
+        return decode_plot_buffer_shared_contents(message_decoder);
+    case MessageType::PlotBufferTiles:
+        return decode_plot_buffer_tiles(message_decoder, frame);
+    case MessageType::PlotBufferCompressedContents:
+        return decode_plot_buffer_compressed_contents(message_decoder);
+    case MessageType::PlotBufferPreview:
+        return decode_plot_buffer_preview(message_decoder, frame);
+    case MessageType::PlotBufferRegion:
+        return decode_plot_buffer_region(message_decoder, frame);
+    case MessageType::PlotBufferUnchanged: {
+        auto message = PlotBufferUnchangedMessage{};
+        message_decoder.read(message.variable_name);
+        return message;
+    }
+    default:
+        return std::monostate{};
+    }
+}
+
+
+IncomingMessage
+NetworkThread::decode_plot_buffer_contents(MessageDecoder& message_decoder,
+                                           MessageFrame& frame)
+{
+    auto message     = PlotBufferMessage{};
+    auto buff_ptr    = static_cast<uint8_t*>(nullptr);
+    auto buff_length = std::size_t{};
+    message_decoder.read(message.metadata).read_view(buff_ptr, buff_length);
+
+    if (!message_decoder.is_valid()) {
+        std::cerr << "[error] Received truncated contents of "
+                  << message.metadata.variable_name << std::endl;
+        return std::monostate{};
+    }
+
+    auto& held_buffer = message.held_buffer;
+    if (message.metadata.type == BufferType::Float64) {
+        held_buffer.contents =
+            make_float_buffer_from_double(buff_ptr, buff_length);
+        held_buffer.data = held_buffer.contents.data();
+        held_buffer.size = held_buffer.contents.size();
+    } else {
+        // The contents are kept inside the frame instead of being copied out
+        held_buffer.frame = std::move(frame);
+        held_buffer.data  = buff_ptr;
+        held_buffer.size  = buff_length;
+    }
+
+    return message;
+}
+
+
+IncomingMessage
+NetworkThread::decode_plot_buffer_preview(MessageDecoder& message_decoder,
+                                          MessageFrame& frame)
+{
+    auto downsampling = int{};
+    message_decoder.read(downsampling);
+
+    // Other than the reduction factor, previews are laid out as contents
+    auto message = decode_plot_buffer_contents(message_decoder, frame);
+
+    if (auto* preview = std::get_if<PlotBufferMessage>(&message)) {
+        preview->region = BufferRegion{.x            = 0,
+                                       .y            = 0,
+                                       .width        = preview->metadata.width,
+                                       .height       = preview->metadata.height,
+                                       .downsampling = downsampling};
+
+        if (!is_region_consistent(*preview)) {
+            std::cerr << "[error] Received malformed preview of "
+                      << preview->metadata.variable_name << std::endl;
+            return std::monostate{};
+        }
+    }
+
+    return message;
+}
+
+
+IncomingMessage
+NetworkThread::decode_plot_buffer_region(MessageDecoder& message_decoder,
+                                         MessageFrame& frame)
+{
+    auto region = BufferRegion{};
+    message_decoder.read(region);
+
+    auto message = decode_plot_buffer_contents(message_decoder, frame);
+
+    if (auto* region_message = std::get_if<PlotBufferMessage>(&message)) {
+        region_message->region       = region;
+        region_message->is_on_demand = true;
+
+        if (!is_region_consistent(*region_message)) {
+            std::cerr << "[error] Received malformed region of "
+                      << region_message->metadata.variable_name << std::endl;
+            return std::monostate{};
+        }
+    }
+
+    return message;
+}
+
+
+bool NetworkThread::is_region_consistent(const PlotBufferMessage& message)
+{
+    const auto& metadata = message.metadata;
+    const auto& region   = *message.region;
+
+    if (region.downsampling < 1 || region.x < 0 || region.y < 0 ||
+        region.width <= 0 || region.height <= 0 ||
+        region.x + region.width > metadata.width ||
+        region.y + region.height > metadata.height) {
+        return false;
+    }
+
+    // Double buffers have already been converted to float
+    const auto held_type = metadata.type == BufferType::Float64
+                               ? BufferType::Float32
+                               : metadata.type;
+
+    const auto width    = static_cast<std::size_t>(region.sampled_width());
+    const auto height   = static_cast<std::size_t>(region.sampled_height());
+    const auto channels = static_cast<std::size_t>(metadata.channels);
+
+    return message.held_buffer.size ==
+           width * height * channels * type_size(held_type);
+}
+
+
+bool NetworkThread::is_contents_size_consistent(const BufferMetadata& metadata,
+                                                const std::size_t size)
+{
+    if (metadata.width < 0 || metadata.height < 0 || metadata.channels < 1 ||
+        metadata.stride < metadata.width) {
+        return false;
+    }
+
+    // Computed without overflowing, since all factors come from the wire
+    auto expected_size = type_size(metadata.type);
+    for (const auto factor : {static_cast<std::size_t>(metadata.stride),
+                              static_cast<std::size_t>(metadata.height),
+                              static_cast<std::size_t>(metadata.channels)}) {
+        if (factor != 0 &&
+            expected_size > std::numeric_limits<std::size_t>::max() / factor) {
+            return false;
+        }
+        expected_size *= factor;
+    }
+
+    return size >= expected_size;
+}
+
+
+IncomingMessage NetworkThread::decode_plot_buffer_shared_contents(
+    MessageDecoder& message_decoder)
+{
+    auto message      = PlotBufferMessage{};
+    auto segment_name = std::string{};
+    auto segment_size = std::size_t{};
+    message_decoder.read(message.metadata)
+        .read(segment_name)
+        .read(segment_size);
+
+    if (!message_decoder.is_valid() ||
+        !is_contents_size_consistent(message.metadata, segment_size)) {
+        std::cerr << "[error] Received malformed shared buffer contents of "
+                  << message.metadata.variable_name << std::endl;
+        SharedMemory::remove(segment_name);
+        return std::monostate{};
+    }
+
+    // Mapping fails if the segment is shorter than announced, which would
+    // otherwise fault once its missing pages are read
+    auto segment = SharedMemory{};
+    if (!segment.open(segment_name, segment_size)) {
+        std::cerr << "[error] Could not map shared buffer contents of "
+                  << message.metadata.variable_name << std::endl;
+        return std::monostate{};
+    }
+
+    // The mapping stays valid after the name is removed, and nothing else will
+    // ever open this segment
+    segment.unlink();
+
+    auto& held_buffer = message.held_buffer;
+    if (message.metadata.type == BufferType::Float64) {
+        held_buffer.contents =
+            make_float_buffer_from_double(segment.data(), segment_size);
+        held_buffer.data = held_buffer.contents.data();
+        held_buffer.size = held_buffer.contents.size();
+    } else {
+        held_buffer.data    = segment.data();
+        held_buffer.size    = segment_size;
+        held_buffer.segment = std::move(segment);
+    }
+
+    return message;
+}
+
+
+IncomingMessage NetworkThread::decode_plot_buffer_compressed_contents(
+    MessageDecoder& message_decoder)
+{
+    auto message     = PlotBufferMessage{};
+    auto codec       = PayloadCodec{};
+    auto buff_length = std::size_t{};
+    auto chunk_count = std::size_t{};
+    message_decoder.read(message.metadata)
+        .read(codec)
+        .read(buff_length)
+        .read(chunk_count);
+
+    // Chunks never hold more than payload_codec_chunk_size bytes, so their
+    // sizes add up without overflowing
+    auto chunks          = std::vector<CompressedChunkView>{};
+    auto chunks_raw_size = std::size_t{0};
+    for (std::size_t c = 0; c < chunk_count && message_decoder.is_valid();
+         ++c) {
+        auto chunk      = CompressedChunkView{};
+        auto chunk_data = static_cast<uint8_t*>(nullptr);
+        message_decoder.read(chunk.raw_size).read_view(chunk_data, chunk.size);
+        if (chunk.raw_size > payload_codec_chunk_size) {
+            break;
+        }
+        chunk.data = chunk_data;
+        chunks.push_back(chunk);
+        chunks_raw_size += chunk.raw_size;
+    }
+
+    // The contents are only allocated once their size, which comes from the
+    // wire, matches both the metadata and the chunks
+    if (!message_decoder.is_valid() || codec != PayloadCodec::ShuffleLz ||
+        chunks.size() != chunk_count || chunks_raw_size != buff_length ||
+        !is_contents_size_consistent(message.metadata, buff_length)) {
+        std::cerr << "[error] Received malformed compressed buffer contents of "
+                  << message.metadata.variable_name << std::endl;
+        return std::monostate{};
+    }
+
+    // Chunks are decompressed in parallel
+    auto contents = std::vector<uint8_t>(buff_length);
+    if (!decompress_payload(chunks,
+                            type_size(message.metadata.type),
+                            contents.data(),
+                            contents.size())) {
+        std::cerr << "[error] Could not decompress contents of "
+                  << message.metadata.variable_name << std::endl;
+        return std::monostate{};
+    }
+
+    auto& held_buffer = message.held_buffer;
+    if (message.metadata.type == BufferType::Float64) {
+        held_buffer.contents = make_float_buffer_from_double(contents);
+    } else {
+        held_buffer.contents = std::move(contents);
+    }
+    held_buffer.data = held_buffer.contents.data();
+    held_buffer.size = held_buffer.contents.size();
+
+    return message;
+}
+
+
+IncomingMessage
+NetworkThread::decode_plot_buffer_tiles(MessageDecoder& message_decoder,
+                                        MessageFrame& frame)
+{
+    auto message     = PlotBufferTilesMessage{};
+    auto buff_length = std::size_t{};
+    auto range_count = std::size_t{};
+    message_decoder.read(message.metadata).read(buff_length).read(range_count);
+
+    message.held_size = buff_length;
+
+    for (std::size_t r = 0; r < range_count && message_decoder.is_valid();
+         ++r) {
+        auto tile      = BufferTilePatch{};
+        auto tile_data = static_cast<uint8_t*>(nullptr);
+        message_decoder.read(tile.offset).read_view(tile_data, tile.size);
+        tile.data = tile_data;
+
+        if (tile.offset + tile.size > buff_length) {
+            break;
+        }
+        message.tiles.push_back(tile);
+    }
+
+    message.is_complete = message_decoder.is_valid() &&
+                          message.tiles.size() == range_count;
+
+    // Double buffers are held as floats, so their tiles are converted here and
+    // their offsets halved
+    if (message.is_complete && message.metadata.type == BufferType::Float64) {
+        constexpr auto ratio = sizeof(double) / sizeof(float);
+
+        // Reserve everything upfront, so that tiles can point into the storage
+        auto converted_size = std::size_t{0};
+        for (const auto& tile : message.tiles) {
+            converted_size += tile.size / ratio;
+        }
+        message.held_size = buff_length / ratio;
+        message.converted_contents.reserve(converted_size);
+
+        for (auto& tile : message.tiles) {
+            const auto float_contents =
+                make_float_buffer_from_double(tile.data, tile.size);
+            const auto converted_offset = message.converted_contents.size();
+            message.converted_contents.insert(message.converted_contents.end(),
+                                              float_contents.begin(),
+                                              float_contents.end());
+
+            tile.offset /= ratio;
+            tile.size = float_contents.size();
+            tile.data = message.converted_contents.data() + converted_offset;
+        }
+    }
+
+    message.frame = std::move(frame);
+
+    return message;
+}
+
+} // namespace oid
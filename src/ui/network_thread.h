@@ -0,0 +1,278 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef NETWORK_THREAD_H_
+#define NETWORK_THREAD_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <QStringList>
+
+#include "ipc/message_exchange.h"
+#include "ipc/spsc_queue.h"
+#include "system/event_notifier/event_notifier.h"
+#include "system/shared_memory/shared_memory.h"
+
+
+namespace oid
+{
+
+struct ConnectionSettings
+{
+    std::string url{};
+    uint16_t port{};
+};
+
+
+/**
+ * Buffer contents kept alive while the buffer is being displayed. Contents are
+ * either owned by the window, left inside the message frame they arrived in,
+ * or mapped from a segment shared with the bridge.
+ */
+struct HeldBuffer
+{
+    std::vector<uint8_t> contents{};
+    MessageFrame frame{};
+    std::optional<SharedMemory> segment{};
+
+    // Location of the buffer within whichever storage above holds it
+    uint8_t* data{};
+    std::size_t size{};
+};
+
+
+///
+// Messages decoded by the network thread, ready to be applied by the GUI
+struct AvailableSymbolsMessage
+{
+    QStringList symbols{};
+};
+
+// Changes to the symbols available since the last list or update was sent
+struct AvailableSymbolsUpdateMessage
+{
+    QStringList added_symbols{};
+    QStringList removed_symbols{};
+};
+
+struct ObservedSymbolsRequest
+{
+};
+
+struct PlotBufferMessage
+{
+    BufferMetadata metadata{}; // Always describes the whole buffer
+    HeldBuffer held_buffer{};
+
+    // Part of the buffer held, if not all of it at full resolution
+    std::optional<BufferRegion> region{};
+
+    // Set if the buffer is too large to be sent whole, in which case the
+    // window requests the regions it displays
+    bool is_on_demand{};
+};
+
+struct BufferTilePatch
+{
+    std::size_t offset{}; // Offset in the held buffer, in bytes
+    const uint8_t* data{};
+    std::size_t size{};
+};
+
+struct PlotBufferTilesMessage
+{
+    BufferMetadata metadata{};
+    std::size_t held_size{};
+    std::vector<BufferTilePatch> tiles{};
+    bool is_complete{};
+
+    // Storage the tiles point into
+    MessageFrame frame{};
+    std::vector<uint8_t> converted_contents{};
+};
+
+// Buffer whose memory was not written since it was last plotted, so the window
+// already holds its contents
+struct PlotBufferUnchangedMessage
+{
+    std::string variable_name{};
+};
+
+using PlotMessage = std::variant<PlotBufferMessage,
+                                 PlotBufferTilesMessage,
+                                 PlotBufferUnchangedMessage>;
+
+// Buffers plotted together by the debugger, to be displayed at once
+struct PlotBufferBatchMessage
+{
+    std::vector<PlotMessage> plots{};
+};
+
+using IncomingMessage = std::variant<std::monostate,
+                                     AvailableSymbolsMessage,
+                                     AvailableSymbolsUpdateMessage,
+                                     ObservedSymbolsRequest,
+                                     PlotBufferMessage,
+                                     PlotBufferTilesMessage,
+                                     PlotBufferUnchangedMessage,
+                                     PlotBufferBatchMessage>;
+
+
+/**
+ * Owns the connection to the debugger bridge. Frames are received and decoded
+ * on a dedicated thread, including the allocation of buffer contents and the
+ * conversion of double buffers, and handed to the GUI thread through a
+ * lock-free queue. Outgoing messages travel through a second queue. The
+ * network thread sleeps until the socket or either queue needs attention.
+ *
+ * on_message_received is called on the network thread after each message is
+ * queued, so that the GUI can be woken up to handle it.
+ */
+class NetworkThread final
+{
+  public:
+    NetworkThread(ConnectionSettings host_settings,
+                  std::function<void()> on_message_received);
+
+    NetworkThread(const NetworkThread&)            = delete;
+    NetworkThread& operator=(const NetworkThread&) = delete;
+
+    ~NetworkThread();
+
+    /**
+     * GUI side: fetch the next decoded message, if any
+     */
+    [[nodiscard]] std::optional<IncomingMessage> try_receive();
+
+    /**
+     * GUI side: queue a message for the bridge. Composed messages must not
+     * reference external payloads, since they are sent asynchronously.
+     */
+    void send(MessageComposer&& message);
+
+    /**
+     * @return false once the connection to the bridge failed or was closed
+     */
+    [[nodiscard]] bool is_connected() const;
+
+  private:
+    static constexpr std::size_t queue_capacity = 64;
+
+    ConnectionSettings host_settings_{};
+    std::function<void()> on_message_received_{};
+
+    SpscQueue<IncomingMessage, queue_capacity> incoming_messages_{};
+    SpscQueue<MessageComposer, queue_capacity> outgoing_messages_{};
+
+    // Notified whenever the network thread may have something new to do: a
+    // message to send, room in the incoming queue or a stop request
+    EventNotifier wakeup_notifier_{};
+
+    // Lets send() wait for room in the outgoing queue
+    std::mutex outgoing_mutex_{};
+    std::condition_variable outgoing_dequeued_{};
+
+    std::atomic<bool> is_connected_{true};
+    std::atomic<bool> is_stop_requested_{false};
+
+    // Batch whose plot messages are still being received. Only accessed by
+    // the network thread.
+    PlotBufferBatchMessage pending_batch_{};
+    std::size_t pending_batch_size_{};
+
+    std::thread thread_{};
+
+    void run();
+
+    /**
+     * Block until the wakeup notifier is notified or, if requested, until the
+     * socket has bytes to read, which are then moved into its buffer
+     */
+    void wait_for_activity(QTcpSocket& socket, bool is_reading);
+
+    /**
+     * Wake up send() if it waits for room in the outgoing queue
+     */
+    void notify_outgoing_dequeued();
+
+    /**
+     * Decode a frame, collecting the messages of a batch until it is complete
+     * @return the decoded message, or std::monostate if there is nothing to
+     *     hand over yet
+     */
+    [[nodiscard]] IncomingMessage receive_message(MessageFrame& frame);
+
+    [[nodiscard]] static IncomingMessage decode_message(MessageFrame& frame);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_contents(MessageDecoder& message_decoder,
+                                MessageFrame& frame);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_preview(MessageDecoder& message_decoder,
+                               MessageFrame& frame);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_region(MessageDecoder& message_decoder,
+                              MessageFrame& frame);
+
+    /**
+     * Check that the region of a preview or region message lies within the
+     * buffer, and that the held contents have the size it implies
+     */
+    [[nodiscard]] static bool
+    is_region_consistent(const PlotBufferMessage& message);
+
+    /**
+     * Check that the contents of a whole buffer are large enough to hold all
+     * of its rows, as described by its metadata
+     */
+    [[nodiscard]] static bool
+    is_contents_size_consistent(const BufferMetadata& metadata,
+                                std::size_t size);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_shared_contents(MessageDecoder& message_decoder);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_compressed_contents(MessageDecoder& message_decoder);
+
+    [[nodiscard]] static IncomingMessage
+    decode_plot_buffer_tiles(MessageDecoder& message_decoder,
+                             MessageFrame& frame);
+};
+
+} // namespace oid
+
+#endif // NETWORK_THREAD_H_
@@ -123,4 +123,13 @@ void SymbolSearchInput::keyPressEvent(QKeyEvent* e)
         completer_->completionModel()->index(0, 0));
 }
 
+
+void SymbolSearchInput::focusInEvent(QFocusEvent* e)
+{
+    QLineEdit::focusInEvent(e);
+
+    // Symbols are only looked up by the debugger once they are needed
+    Q_EMIT focused();
+}
+
 } // namespace oid
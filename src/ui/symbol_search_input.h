@@ -50,9 +50,14 @@ class SymbolSearchInput final : public QLineEdit
 
     [[nodiscard]] SymbolCompleter* symbolCompleter() const;
 
+  Q_SIGNALS:
+    void focused();
+
   protected:
     void keyPressEvent(QKeyEvent* e) override;
 
+    void focusInEvent(QFocusEvent* e) override;
+
   private Q_SLOTS:
     void insert_completion(const QString& completion);
 
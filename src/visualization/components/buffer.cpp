@@ -25,10 +25,15 @@
 
 #include "buffer.h"
 
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <cmath>
 #include <limits>
+#include <optional>
+#include <ranges>
 #include <string>
+#include <utility>
 
 #include "GL/gl.h"
 
@@ -37,10 +42,148 @@
 #include "visualization/game_object.h"
 #include "visualization/shaders/oid_shaders.h"
 #include "visualization/stage.h"
+#include "visualization/texture_cache.h"
+#include "visualization/texture_uploader.h"
 
 namespace oid
 {
 
+namespace
+{
+
+struct TextureFormat
+{
+    GLint internal_format{};
+    GLenum format{};
+    GLenum type{};
+    int channel_size{}; // Of the uploaded pixels, in bytes
+    int texel_size{};   // Of the texture, in bytes
+};
+
+
+/**
+ * Texture format that stores the pixels of a buffer as they are. Integer
+ * types use normalized formats, which sample to the same values as the
+ * conversion to float done by the driver when uploading them to a floating
+ * point texture. There is no normalized format for 32-bit integers, which
+ * are stored as floats instead.
+ *
+ * Formats the context does not support fall back to those of the baseline:
+ * one and two channels are stored as RGBA, and signed shorts as floats.
+ */
+TextureFormat texture_format(const BufferType type,
+                             const int channels,
+                             const GLCapabilities& capabilities)
+{
+    // clang-format off
+    static constexpr auto formats =
+        std::array<GLenum, 4>{GL_RED, GL_RG, GL_RGB, GL_RGBA};
+    static constexpr auto unorm8_formats =
+        std::array<GLint, 4>{GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+    static constexpr auto unorm16_formats =
+        std::array<GLint, 4>{GL_R16, GL_RG16, GL_RGB16, GL_RGBA16};
+    static constexpr auto snorm16_formats = std::array<GLint, 4>{
+        GL_R16_SNORM, GL_RG16_SNORM, GL_RGB16_SNORM, GL_RGBA16_SNORM};
+    static constexpr auto float_formats =
+        std::array<GLint, 4>{GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F};
+    // clang-format on
+
+    const auto c = static_cast<std::size_t>(std::clamp(channels, 1, 4) - 1);
+
+    // Channels held by the texture
+    const auto t = capabilities.texture_rg || c >= 2 ? c : std::size_t{3};
+    const auto texel_channels = static_cast<int>(t + 1);
+
+    switch (type) {
+    case BufferType::UnsignedByte:
+        return {unorm8_formats[t], formats[c], GL_UNSIGNED_BYTE, 1,
+                texel_channels};
+    case BufferType::UnsignedShort:
+        return {unorm16_formats[t], formats[c], GL_UNSIGNED_SHORT, 2,
+                texel_channels * 2};
+    case BufferType::Short:
+        if (capabilities.texture_snorm) {
+            return {snorm16_formats[t], formats[c], GL_SHORT, 2,
+                    texel_channels * 2};
+        }
+        return {float_formats[t], formats[c], GL_SHORT, 2, texel_channels * 4};
+    case BufferType::Int32:
+        return {float_formats[t], formats[c], GL_INT, 4, texel_channels * 4};
+    case BufferType::Float32:
+    case BufferType::Float64:
+        // Float64 buffers are converted to Float32 once received
+        break;
+    }
+
+    return {float_formats[t], formats[c], GL_FLOAT, 4, texel_channels * 4};
+}
+
+
+/**
+ * Number of levels in the full mip chain of a texture, down to 1x1
+ */
+int mip_levels(const int width, const int height)
+{
+    return std::bit_width(static_cast<unsigned int>((std::max)(width, height)));
+}
+
+
+/**
+ * Memory taken by a texture, in bytes
+ */
+std::size_t get_texture_memory_size(const int width,
+                                    const int height,
+                                    const int texel_size,
+                                    const bool has_mip_levels)
+{
+    const auto size = static_cast<std::size_t>(width) *
+                      static_cast<std::size_t>(height) *
+                      static_cast<std::size_t>(texel_size);
+
+    // Mip levels take a third of the first one
+    return has_mip_levels ? size * 4 / 3 : size;
+}
+
+
+/**
+ * Distance from the center of the view to the center of a tile, in clip
+ * coordinates
+ * @param tile_mvp transform of the unit square to the clip space
+ * @return std::nullopt if the tile is out of the view
+ */
+std::optional<double> get_view_distance(const mat4& tile_mvp)
+{
+    auto lower = vec4{std::numeric_limits<double>::max(),
+                      std::numeric_limits<double>::max(),
+                      0.0,
+                      1.0};
+    auto upper = vec4{std::numeric_limits<double>::lowest(),
+                      std::numeric_limits<double>::lowest(),
+                      0.0,
+                      1.0};
+    for (const auto& [corner_x, corner_y] : {std::pair{-0.5, -0.5},
+                                             std::pair{0.5, -0.5},
+                                             std::pair{-0.5, 0.5},
+                                             std::pair{0.5, 0.5}}) {
+        const auto corner = tile_mvp * vec4{corner_x, corner_y, 0.0, 1.0};
+        lower.x()         = (std::min)(lower.x(), corner.x());
+        lower.y()         = (std::min)(lower.y(), corner.y());
+        upper.x()         = (std::max)(upper.x(), corner.x());
+        upper.y()         = (std::max)(upper.y(), corner.y());
+    }
+
+    if (upper.x() < -1.0 || lower.x() > 1.0 || upper.y() < -1.0 ||
+        lower.y() > 1.0) {
+        return std::nullopt;
+    }
+
+    const auto center = tile_mvp * vec4{0.0, 0.0, 0.0, 1.0};
+    return std::hypot(center.x(), center.y());
+}
+
+} // namespace
+
+
 constexpr std::array<float, 8>
     Buffer::no_ac_params{1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 
@@ -54,18 +197,15 @@ Buffer::Buffer(GameObject* game_object, GLCanvas* gl_canvas)
 
 Buffer::~Buffer()
 {
-    const auto num_textures = num_textures_x * num_textures_y;
+    cancel_texture_upload();
+    release_textures();
 
-    gl_canvas_->glDeleteTextures(num_textures, buff_tex.data());
     gl_canvas_->glDeleteBuffers(1, &vbo_);
 }
 
 
 bool Buffer::buffer_update()
 {
-    const auto num_textures = num_textures_x * num_textures_y;
-    glDeleteTextures(num_textures, buff_tex.data());
-
     create_shader_program();
     setup_gl_buffer();
     return true;
@@ -73,16 +213,29 @@ bool Buffer::buffer_update()
 
 
 void Buffer::get_pixel_info(std::stringstream& message,
-                            const int x,
-                            const int y) const
+                            const std::int64_t x,
+                            const std::int64_t y) const
 {
-    if (x < 0 || static_cast<float>(x) >= buffer_width_f || y < 0 ||
-        static_cast<float>(y) >= buffer_height_f) {
+    if (x < 0 || x >= full_width || y < 0 || y >= full_height) {
         message << "[out of bounds]";
         return;
     }
 
-    const auto pos = channels * (y * step + x);
+    if (x < region.x || y < region.y) {
+        message << "[not loaded]";
+        return;
+    }
+
+    const auto held_x = (x - region.x) / region.downsampling;
+    const auto held_y = (y - region.y) / region.downsampling;
+
+    if (static_cast<float>(held_x) >= buffer_width_f ||
+        static_cast<float>(held_y) >= buffer_height_f) {
+        message << "[not loaded]";
+        return;
+    }
+
+    const auto pos = channels * (held_y * step + held_x);
 
     message << "[";
 
@@ -118,8 +271,10 @@ void Buffer::rotate(const float angle)
 }
 
 
-void Buffer::set_icon_drawing_mode(const bool is_enabled) const
+void Buffer::set_icon_drawing_mode(const bool is_enabled)
 {
+    is_icon_drawing_mode_ = is_enabled;
+
     buff_prog_.use();
 
     buff_prog_.uniform1i("enable_icon_mode", is_enabled ? 1 : 0);
@@ -127,7 +282,7 @@ void Buffer::set_icon_drawing_mode(const bool is_enabled) const
 
 
 void Buffer::update_min_color_value(float* lowest,
-                                    const int i,
+                                    const std::int64_t i,
                                     const int c) const
 {
     if (type == BufferType::Float32 || type == BufferType::Float64) {
@@ -182,7 +337,7 @@ void Buffer::recompute_min_color_values()
 
 
 void Buffer::update_max_color_value(float* upper,
-                                    const int i,
+                                    const std::int64_t i,
                                     const int c) const
 {
     if (type == BufferType::Float32 || type == BufferType::Float64) {
@@ -289,6 +444,11 @@ void Buffer::compute_contrast_brightness_parameters()
 
 int Buffer::sub_texture_id_at_coord(const int x, const int y) const
 {
+    // Nothing is displayed until the buffer is set up
+    if (buff_tex.empty()) {
+        return 0;
+    }
+
     const auto tx = x / max_texture_size;
     const auto ty = y / max_texture_size;
     return static_cast<int>(buff_tex[ty * num_textures_x + tx]);
@@ -392,6 +552,27 @@ void Buffer::update_object_pose() const
 }
 
 
+mat4 Buffer::region_pose() const
+{
+    // Held pixels are stretched over the full resolution pixels they sample,
+    // so that the view does not change when a different region is displayed.
+    // The offsets are computed in double precision, since single precision
+    // floats cannot tell pixels apart past 2^24 columns or rows.
+    const auto downsampling = static_cast<double>(region.downsampling);
+    const auto region_center_x =
+        static_cast<double>(region.x) +
+        downsampling * static_cast<double>(buffer_width_f) / 2.0 -
+        static_cast<double>(full_width) / 2.0;
+    const auto region_center_y =
+        static_cast<double>(region.y) +
+        downsampling * static_cast<double>(buffer_height_f) / 2.0 -
+        static_cast<double>(full_height) / 2.0;
+
+    return mat4::translation(vec4{region_center_x, region_center_y, 0.0, 1.0}) *
+           mat4::scale(vec4{downsampling, downsampling, 1.0, 1.0});
+}
+
+
 void Buffer::create_shader_program()
 {
     // Buffer Shaders
@@ -453,8 +634,13 @@ bool Buffer::initialize()
 
 void Buffer::draw(const mat4& projection, const mat4& viewInv)
 {
+    // Nothing is displayed until the buffer is set up
+    if (buff_tex.empty()) {
+        return;
+    }
+
     buff_prog_.use();
-    const auto model = game_object_->get_pose();
+    const auto model = game_object_->get_pose() * region_pose();
     const auto mvp   = projection * viewInv * model;
 
     gl_canvas_->glEnableVertexAttribArray(0);
@@ -471,6 +657,22 @@ void Buffer::draw(const mat4& projection, const mat4& viewInv)
     const auto buffer_width_i  = static_cast<int>(buffer_width_f);
     const auto buffer_height_i = static_cast<int>(buffer_height_f);
 
+    const auto texture_cache = gl_canvas_->get_texture_cache();
+
+    // Each tile is drawn on its own, since each has its own texture so that
+    // the texture cache can evict it alone. Uniform locations are looked up
+    // once, rather than by name for every tile.
+    const auto mvp_location = buff_prog_.uniform_location("mvp");
+    const auto buffer_dimension_location =
+        buff_prog_.uniform_location("buffer_dimension");
+
+    gl_canvas_->glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    gl_canvas_->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // Visible tiles without a texture, along with their distance from the
+    // center of the view
+    auto missing_tiles = std::vector<std::pair<double, int>>{};
+
     auto remaining_h = buffer_height_i;
 
     auto py = static_cast<float>(-buffer_height_i) / 2.0f;
@@ -498,7 +700,7 @@ void Buffer::draw(const mat4& projection, const mat4& viewInv)
             const auto buff_w = (std::min)(remaining_w, max_texture_size);
             remaining_w -= buff_w;
 
-            glBindTexture(GL_TEXTURE_2D, buff_tex[ty * num_textures_x + tx]);
+            const auto tile_id = ty * num_textures_x + tx;
 
             auto tile_model = mat4{};
 
@@ -513,22 +715,51 @@ void Buffer::draw(const mat4& projection, const mat4& viewInv)
                                    px,
                                    py,
                                    0.0f);
+            const auto tile_mvp = mvp * tile_model;
+
+            px += static_cast<float>(buff_w) / 2.0f;
+
+            // Tiles out of the view are culled
+            const auto distance = get_view_distance(tile_mvp);
+            if (!distance.has_value()) {
+                continue;
+            }
+
+            const auto texture = buff_tex[tile_id];
+            if (texture == 0) {
+                if (!is_icon_drawing_mode_) {
+                    missing_tiles.emplace_back(*distance, tile_id);
+                }
+                continue;
+            }
+            if (!is_icon_drawing_mode_) {
+                texture_cache->touch(texture);
+            }
+
+            glBindTexture(GL_TEXTURE_2D, texture);
             buff_prog_.uniform_matrix4fv(
-                "mvp", 1, GL_FALSE, (mvp * tile_model).data());
-            buff_prog_.uniform2f("buffer_dimension",
+                mvp_location, 1, GL_FALSE, tile_mvp.to_float().data());
+            buff_prog_.uniform2f(buffer_dimension_location,
                                  static_cast<float>(buff_w),
                                  static_cast<float>(buff_h));
 
-            px += static_cast<float>(buff_w) / 2.0f;
-
-            gl_canvas_->glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-            gl_canvas_->glVertexAttribPointer(
-                0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
             gl_canvas_->glDrawArrays(GL_TRIANGLES, 0, 6);
         }
 
         py += static_cast<float>(buff_h) / 2.0f;
     }
+
+    // Tiles evicted from the texture cache are uploaded again once visible,
+    // those closest to the center of the view first
+    if (!missing_tiles.empty() && pending_upload_ == nullptr) {
+        std::ranges::sort(missing_tiles);
+
+        auto tile_ids = std::vector<int>{};
+        for (const auto tile_id : missing_tiles | std::views::values) {
+            tile_ids.push_back(tile_id);
+        }
+        upload_tiles(tile_ids);
+    }
 }
 
 
@@ -558,6 +789,10 @@ void Buffer::setup_gl_buffer()
     // Initialize contrast parameters
     reset_contrast_brightness_parameters();
 
+    // Tiles never grow past max_tile_size, whatever the context supports
+    max_texture_size =
+        (std::min)(gl_canvas_->get_max_texture_size(), max_tile_size);
+
     // Buffer texture
     num_textures_x         = std::ceil(static_cast<float>(buffer_width_i) /
                                static_cast<float>(max_texture_size));
@@ -565,81 +800,133 @@ void Buffer::setup_gl_buffer()
                                static_cast<float>(max_texture_size));
     const int num_textures = num_textures_x * num_textures_y;
 
-    buff_tex.resize(num_textures);
-    glGenTextures(num_textures, buff_tex.data());
-
-    auto tex_type   = GLuint{GL_UNSIGNED_BYTE};
-    auto tex_format = GLuint{GL_RED};
+    // The displayed textures are updated in place as long as they still fit
+    // the buffer, and replaced by new ones otherwise
+    cancel_texture_upload();
+    const auto is_updated_in_place =
+        displayed_region_ == region && displayed_channels_ == channels &&
+        displayed_type_ == type &&
+        static_cast<int>(buff_tex.size()) == num_textures;
+
+    if (!is_updated_in_place) {
+        release_textures();
+        buff_tex.assign(num_textures, 0);
+        tile_hashes_.assign(num_textures, std::nullopt);
+
+        displayed_region_   = region;
+        displayed_channels_ = channels;
+        displayed_type_     = type;
+    }
 
-    if (type == BufferType::Float32 || type == BufferType::Float64) {
-        tex_type = GL_FLOAT;
-    } else if (type == BufferType::UnsignedByte) {
-        tex_type = GL_UNSIGNED_BYTE;
-    } else if (type == BufferType::Short) {
-        tex_type = GL_SHORT;
-    } else if (type == BufferType::UnsignedShort) {
-        tex_type = GL_UNSIGNED_SHORT;
-    } else if (type == BufferType::Int32) {
-        tex_type = GL_INT;
+    // Tiles evicted from the texture cache are left out, and uploaded again
+    // once drawn
+    auto tile_ids = std::vector<int>{};
+    for (int tile_id = 0; tile_id < num_textures; ++tile_id) {
+        if (!is_updated_in_place || buff_tex[tile_id] != 0) {
+            tile_ids.push_back(tile_id);
+        }
     }
 
-    if (channels == 1) {
-        tex_format = GL_RED;
-    } else if (channels == 2) {
-        tex_format = GL_RG;
-    } else if (channels == 3) {
-        tex_format = GL_RGB;
-    } else if (channels == 4) {
-        tex_format = GL_RGBA;
+    upload_tiles(tile_ids);
+}
+
+
+void Buffer::upload_tiles(const std::vector<int>& tile_ids)
+{
+    if (tile_ids.empty()) {
+        return;
     }
 
-    auto remaining_h = buffer_height_i;
+    const auto buffer_width_i  = static_cast<int>(buffer_width_f);
+    const auto buffer_height_i = static_cast<int>(buffer_height_f);
 
-    glPixelStoref(GL_UNPACK_ALIGNMENT, 1);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, step);
+    const auto& capabilities = gl_canvas_->get_capabilities();
+    const auto [tex_internal_format,
+                tex_format,
+                tex_type,
+                channel_size,
+                texel_size] = texture_format(type, channels, capabilities);
+
+    // Without glGenerateMipmap, zoomed out tiles are sampled from their first
+    // level only
+    auto upload_request = TextureUploadRequest{
+        .pixels         = buffer,
+        .row_length     = step,
+        .pixel_size     = channels * channel_size,
+        .format         = tex_format,
+        .type           = tex_type,
+        .has_mip_levels = capabilities.generate_mipmap,
+    };
 
-    for (int ty = 0; ty < num_textures_y; ++ty) {
-        const auto buff_h = (std::min)(remaining_h, max_texture_size);
-        remaining_h -= buff_h;
+    // Tiles holding the same pixels as their texture are left untouched. They
+    // are hashed before anything is allocated, so that only the tiles which
+    // changed are given new textures.
+    auto changed_tile_ids = std::vector<int>{};
+    for (const auto tile_id : tile_ids) {
+        const auto x = (tile_id % num_textures_x) * max_texture_size;
+        const auto y = (tile_id / num_textures_x) * max_texture_size;
+        const auto buff_w = (std::min)(buffer_width_i - x, max_texture_size);
+        const auto buff_h = (std::min)(buffer_height_i - y, max_texture_size);
+        auto tile = TextureTile{.texture = buff_tex[tile_id],
+                                .x       = x,
+                                .y       = y,
+                                .width   = buff_w,
+                                .height  = buff_h};
+
+        tile.pixels_hash = hash_tile_pixels(upload_request, tile);
+        if (tile.texture != 0 && tile.pixels_hash == tile_hashes_[tile_id]) {
+            continue;
+        }
 
-        auto remaining_w = buffer_width_i;
-        for (int tx = 0; tx < num_textures_x; ++tx) {
-            const auto buff_w = (std::min)(remaining_w, max_texture_size);
-            remaining_w -= buff_w;
+        changed_tile_ids.push_back(tile_id);
+        upload_request.tiles.push_back(tile);
+    }
 
-            const auto tex_id = ty * num_textures_x + tx;
-            gl_canvas_->glBindTexture(GL_TEXTURE_2D, buff_tex[tex_id]);
-
-            gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_ROWS,
-                                      ty * max_texture_size);
-            gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_PIXELS,
-                                      tx * max_texture_size);
-
-            gl_canvas_->glTexImage2D(GL_TEXTURE_2D,
-                                     0,
-                                     GL_RGBA32F,
-                                     buff_w,
-                                     buff_h,
-                                     0,
-                                     tex_format,
-                                     tex_type,
-                                     nullptr);
-
-            gl_canvas_->glTexSubImage2D(GL_TEXTURE_2D,
-                                        0,
-                                        0,
-                                        0,
-                                        buff_w,
-                                        buff_h,
-                                        tex_format,
-                                        tex_type,
-                                        std::bit_cast<const GLvoid*>(buffer));
+    if (changed_tile_ids.empty()) {
+        return;
+    }
+
+    const auto uploader = gl_canvas_->get_texture_uploader();
+
+    // Room is made for the textures about to be allocated right away, rather
+    // than once the next frame is finished
+    auto allocated_size = std::size_t{0};
+    for (const auto& tile : upload_request.tiles) {
+        if (tile.texture == 0 || uploader != nullptr) {
+            allocated_size +=
+                get_texture_memory_size(tile.width,
+                                        tile.height,
+                                        texel_size,
+                                        upload_request.has_mip_levels);
+        }
+    }
+    gl_canvas_->get_texture_cache()->make_room(allocated_size);
+
+    for (auto& tile : upload_request.tiles) {
+        // Displayed textures are only updated in place on this thread. The
+        // uploader fills new ones, which replace them once complete, so that
+        // no texture is written while it is drawn.
+        if (tile.texture == 0 || uploader != nullptr) {
+            glGenTextures(1, &tile.texture);
+            gl_canvas_->glBindTexture(GL_TEXTURE_2D, tile.texture);
+
+            gl_canvas_->allocate_texture_storage(
+                upload_request.has_mip_levels
+                    ? mip_levels(tile.width, tile.height)
+                    : 1,
+                tex_internal_format,
+                tile.width,
+                tile.height,
+                tex_format,
+                tex_type);
 
             gl_canvas_->glTexParameteri(
                 GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            gl_canvas_->glTexParameteri(
-                GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            gl_canvas_->glTexParameteri(GL_TEXTURE_2D,
+                                        GL_TEXTURE_MIN_FILTER,
+                                        upload_request.has_mip_levels
+                                            ? GL_LINEAR_MIPMAP_LINEAR
+                                            : GL_LINEAR);
             gl_canvas_->glTexParameteri(
                 GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             gl_canvas_->glTexParameteri(
@@ -649,9 +936,152 @@ void Buffer::setup_gl_buffer()
         }
     }
 
+    pending_tile_ids_ = std::move(changed_tile_ids);
+
+    if (uploader != nullptr) {
+        // Make the allocated textures visible to the uploader context
+        gl_canvas_->glFlush();
+
+        pending_upload_ = uploader->upload(std::move(upload_request));
+        return;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(step));
+
+    for (auto& tile : upload_request.tiles) {
+        tile.is_uploaded = true;
+
+        gl_canvas_->glBindTexture(GL_TEXTURE_2D, tile.texture);
+
+        gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_ROWS,
+                                  static_cast<GLint>(tile.y));
+        gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_PIXELS,
+                                  static_cast<GLint>(tile.x));
+
+        gl_canvas_->glTexSubImage2D(GL_TEXTURE_2D,
+                                    0,
+                                    0,
+                                    0,
+                                    tile.width,
+                                    tile.height,
+                                    tex_format,
+                                    tex_type,
+                                    std::bit_cast<const GLvoid*>(buffer));
+        if (upload_request.has_mip_levels) {
+            gl_canvas_->glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
+
     gl_canvas_->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
     gl_canvas_->glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+
+    finish_texture_upload(std::move(upload_request.tiles), true);
+}
+
+
+void Buffer::finish_texture_upload(std::vector<TextureTile> tiles,
+                                   const bool is_complete)
+{
+    const auto& capabilities = gl_canvas_->get_capabilities();
+    const auto texel_size =
+        texture_format(type, channels, capabilities).texel_size;
+    const auto texture_cache = gl_canvas_->get_texture_cache();
+
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        const auto tile_id           = pending_tile_ids_[i];
+        const auto& tile             = tiles[i];
+        const auto displayed_texture = buff_tex[tile_id];
+
+        // Textures updated in place are already tracked by the cache
+        if (tile.texture == displayed_texture) {
+            tile_hashes_[tile_id] = tile.pixels_hash;
+            continue;
+        }
+
+        // New textures only replace the displayed ones once filled, and are
+        // dropped if their upload was cancelled
+        if (!is_complete || !tile.is_uploaded) {
+            gl_canvas_->glDeleteTextures(1, &tile.texture);
+            continue;
+        }
+
+        if (displayed_texture != 0) {
+            texture_cache->erase(displayed_texture);
+            gl_canvas_->glDeleteTextures(1, &displayed_texture);
+        }
+
+        buff_tex[tile_id]     = tile.texture;
+        tile_hashes_[tile_id] = tile.pixels_hash;
+
+        texture_cache->insert(
+            tile.texture,
+            get_texture_memory_size(tile.width,
+                                    tile.height,
+                                    texel_size,
+                                    capabilities.generate_mipmap),
+            [this, tile_id] { release_tile(tile_id); });
+    }
+
+    pending_tile_ids_.clear();
+}
+
+
+void Buffer::release_tile(const int tile_id)
+{
+    gl_canvas_->glDeleteTextures(1, &buff_tex[tile_id]);
+    buff_tex[tile_id]     = 0;
+    tile_hashes_[tile_id] = std::nullopt;
+}
+
+
+void Buffer::release_textures()
+{
+    const auto texture_cache = gl_canvas_->get_texture_cache();
+    for (const auto texture : buff_tex) {
+        if (texture != 0) {
+            texture_cache->erase(texture);
+            gl_canvas_->glDeleteTextures(1, &texture);
+        }
+    }
+
+    buff_tex.clear();
+    tile_hashes_.clear();
+}
+
+
+bool Buffer::collect_texture_upload()
+{
+    if (pending_upload_ == nullptr || !pending_upload_->is_complete()) {
+        return false;
+    }
+
+    auto tiles = pending_upload_->take_tiles();
+    pending_upload_.reset();
+    finish_texture_upload(std::move(tiles), true);
+
+    return true;
+}
+
+
+bool Buffer::is_texture_upload_pending() const
+{
+    return pending_upload_ != nullptr;
+}
+
+
+void Buffer::cancel_texture_upload()
+{
+    if (pending_upload_ == nullptr) {
+        return;
+    }
+
+    pending_upload_->cancel();
+
+    auto tiles = pending_upload_->take_tiles();
+    pending_upload_.reset();
+    finish_texture_upload(std::move(tiles), false);
 }
 
 } // namespace oid
@@ -27,17 +27,24 @@
 #define BUFFER_H_
 
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "component.h"
+#include "ipc/buffer_preview.h"
 #include "ipc/raw_data_decode.h"
 #include "visualization/shader.h"
 
 namespace oid
 {
 
+struct TextureTile;
+class TextureUpload;
+
 class Buffer final : public Component
 {
   public:
@@ -53,8 +60,16 @@ class Buffer final : public Component
 
     Buffer& operator=(Buffer&&) = delete;
 
-    static constexpr int max_texture_size = 2048;
+    // Tiles are this wide, so that they are updated and evicted from the
+    // texture cache at a fine grain
+    static constexpr int max_tile_size = 2048;
+
+    // Width of the tiles, which is only below max_tile_size for contexts that
+    // cannot hold textures that large
+    int max_texture_size{max_tile_size};
 
+    // Textures displayed, one per tile of max_texture_size pixels. Tiles not
+    // uploaded yet, or evicted from the texture cache, have none.
     std::vector<GLuint> buff_tex{};
 
     static const std::array<float, 8> no_ac_params;
@@ -63,7 +78,7 @@ class Buffer final : public Component
     float buffer_height_f{};
 
     int channels{};
-    int step{};
+    std::int64_t step{};
 
     BufferType type{BufferType::UnsignedByte};
 
@@ -71,6 +86,12 @@ class Buffer final : public Component
 
     bool transpose{};
 
+    // Dimensions of the whole buffer, in full resolution pixels. The pixels
+    // held in buffer may only cover part of it, at a lower resolution.
+    std::int64_t full_width{};
+    std::int64_t full_height{};
+    BufferRegion region{};
+
     bool buffer_update() override;
 
     void recompute_min_color_values();
@@ -105,22 +126,73 @@ class Buffer final : public Component
 
     [[nodiscard]] const float* auto_buffer_contrast_brightness() const;
 
-    void get_pixel_info(std::stringstream& message, int x, int y) const;
+    /**
+     * Describe the value of a pixel
+     * @param x column of the pixel, in full resolution pixels
+     * @param y row of the pixel, in full resolution pixels
+     */
+    void get_pixel_info(std::stringstream& message,
+                        std::int64_t x,
+                        std::int64_t y) const;
+
+    /**
+     * Placement of the held pixels in the object space of the whole buffer
+     */
+    [[nodiscard]] mat4 region_pose() const;
 
     void rotate(float angle);
 
-    void set_icon_drawing_mode(bool is_enabled) const;
+    /**
+     * Icons are drawn from the tiles that have a texture, without uploading
+     * the others or marking them as drawn in the texture cache
+     */
+    void set_icon_drawing_mode(bool is_enabled);
+
+    /**
+     * Display the textures filled by a background upload, once it completed
+     * @return true if the displayed textures changed
+     */
+    bool collect_texture_upload();
+
+    [[nodiscard]] bool is_texture_upload_pending() const;
+
+    /**
+     * Stop the pending upload from reading buffer. Must be called before the
+     * contents of buffer are modified or freed.
+     */
+    void cancel_texture_upload();
 
   private:
     void create_shader_program();
 
     void setup_gl_buffer();
 
+    /**
+     * Upload the pixels of the given tiles, in the background if possible.
+     * Textures are created for tiles that have none, and for every tile
+     * uploaded in the background.
+     */
+    void upload_tiles(const std::vector<int>& tile_ids);
+
+    void finish_texture_upload(std::vector<TextureTile> tiles,
+                               bool is_complete);
+
+    /**
+     * Delete the texture of a tile evicted from the texture cache
+     */
+    void release_tile(int tile_id);
+
+    void release_textures();
+
     void update_object_pose() const;
 
-    void update_min_color_value(float* lowest, const int i, const int c) const;
+    void update_min_color_value(float* lowest,
+                                const std::int64_t i,
+                                const int c) const;
 
-    void update_max_color_value(float* upper, const int i, const int c) const;
+    void update_max_color_value(float* upper,
+                                const std::int64_t i,
+                                const int c) const;
 
     std::string pixel_layout_{'r', 'g', 'b', 'a'};
 
@@ -138,6 +210,23 @@ class Buffer final : public Component
 
     ShaderProgram buff_prog_{nullptr};
     GLuint vbo_{};
+
+    bool is_icon_drawing_mode_{false};
+
+    // Tiles being filled in the background, in the order of the upload
+    // request. Their textures are displayed once the upload completes.
+    std::vector<int> pending_tile_ids_{};
+    std::shared_ptr<TextureUpload> pending_upload_{};
+
+    // Layout of the tiles in buff_tex
+    BufferRegion displayed_region_{};
+    int displayed_channels_{};
+    BufferType displayed_type_{BufferType::UnsignedByte};
+
+    // Hashes of the pixels held by each texture of buff_tex. Textures which
+    // still fit the buffer are updated, with only the tiles whose pixels hash
+    // differently uploaded again.
+    std::vector<std::optional<std::uint64_t>> tile_hashes_{};
 };
 
 } // namespace oid
@@ -64,7 +64,7 @@ int BufferValues::render_index() const
 
 inline void pix2str(const BufferType& type,
                     const uint8_t* buffer,
-                    const int& pos,
+                    const std::int64_t& pos,
                     const int& channel,
                     const int label_length,
                     const int float_precision,
@@ -141,10 +141,11 @@ void BufferValues::draw(const mat4& projection, const mat4& view_inv)
     const auto zoom    = camera->compute_zoom();
 
     if (zoom > 40.0f) {
-        const auto buffer_pose = game_object_->get_pose();
-
         const auto buffer_component =
             game_object_->get_component<Buffer>("buffer_component");
+        const auto buffer_pose =
+            game_object_->get_pose() * buffer_component->region_pose();
+
         const auto buffer_width_f  = buffer_component->buffer_width_f;
         const auto buffer_height_f = buffer_component->buffer_height_f;
         const auto channels        = buffer_component->channels;
@@ -260,8 +261,6 @@ void BufferValues::draw_text(const mat4& projection,
     glBindTexture(GL_TEXTURE_2D, text_renderer->text_tex);
     text_renderer->text_prog.uniform1i("text_sampler", 1);
 
-    text_renderer->text_prog.uniform_matrix4fv(
-        "mvp", 1, GL_FALSE, (projection * view_inv).data());
     text_renderer->text_prog.uniform2f(
         "pix_coord",
         buffer_component->tile_coord_x(x_plus_half_buffer_width),
@@ -302,8 +301,19 @@ void BufferValues::draw_text(const mat4& projection,
 
     centeredCoord = buffer_pose * centeredCoord;
 
-    y = centeredCoord.y() + boxH / 2.0f * sy - channel_offset.y();
-    x = centeredCoord.x() - boxW / 2.0f * sx - channel_offset.x();
+    // The glyphs are laid out around the pixel center, which is moved to its
+    // place in double precision. World coordinates of gigapixel buffers would
+    // not fit in the single precision vertices.
+    const auto text_pose = mat4::translation(
+        vec4{centeredCoord.x(), centeredCoord.y(), 0.0, 1.0});
+    text_renderer->text_prog.uniform_matrix4fv(
+        "mvp",
+        1,
+        GL_FALSE,
+        (projection * view_inv * text_pose).to_float().data());
+
+    y = boxH / 2.0f * sy - static_cast<float>(channel_offset.y());
+    x = -boxW / 2.0f * sx - static_cast<float>(channel_offset.x());
 
     for (const auto c : std::string{text}) {
         const auto uchar = static_cast<unsigned char>(c);
@@ -356,8 +366,8 @@ void BufferValues::draw_text(const mat4& projection,
             0.0f,
             1.0f};
 
-        x += char_step_direction.x();
-        y += char_step_direction.y();
+        x += static_cast<float>(char_step_direction.x());
+        y += static_cast<float>(char_step_direction.y());
     }
 }
 
@@ -101,14 +101,16 @@ void Camera::update()
     handle_key_events();
 }
 
-std::pair<float, float> Camera::get_buffer_initial_dimensions() const
+std::pair<double, double> Camera::get_buffer_initial_dimensions() const
 {
     const auto buffer_obj = game_object_->stage->get_game_object("buffer");
     const auto buff = buffer_obj->get_component<Buffer>("buffer_component");
 
-    const auto buf_dim =
-        buffer_obj->get_pose() *
-        vec4(buff->buffer_width_f, buff->buffer_height_f, 0, 1);
+    const auto buf_dim = buffer_obj->get_pose() *
+                         vec4(static_cast<double>(buff->full_width),
+                              static_cast<double>(buff->full_height),
+                              0.0,
+                              1.0);
 
     const auto x = std::abs(buf_dim.x());
     const auto y = std::abs(buf_dim.y());
@@ -230,10 +232,10 @@ void Camera::scale_at(const vec4& center_ndc, const float delta)
             get_buffer_initial_dimensions();
 
         // Find the lowest allowed zoom ratio.
-        const auto zoom_lowest_x =
-            ratio_lowest * static_cast<float>(canvas_width_) / buffer_width;
-        const auto zoom_lowest_y =
-            ratio_lowest * static_cast<float>(canvas_height_) / buffer_height;
+        const auto zoom_lowest_x = static_cast<float>(
+            ratio_lowest * static_cast<double>(canvas_width_) / buffer_width);
+        const auto zoom_lowest_y = static_cast<float>(
+            ratio_lowest * static_cast<double>(canvas_height_) / buffer_height);
         const auto zoom_lowest = (std::min)(zoom_lowest_x, zoom_lowest_y);
 
         // Find the lowest allowed zoom power.
@@ -353,14 +355,16 @@ float Camera::compute_zoom() const
 }
 
 
-void Camera::move_to(const float x, const float y)
+void Camera::move_to(const double x, const double y)
 {
     const auto buffer_obj = game_object_->stage->get_game_object("buffer");
 
     const auto buff = buffer_obj->get_component<Buffer>("buffer_component");
-    const auto buf_dim =
-        vec4(buff->buffer_width_f, buff->buffer_height_f, 0.0f, 1.0f);
-    const auto centered_coord = buf_dim * 0.5f - vec4(x, y, 0.0f, 0.0f);
+    const auto buf_dim = vec4(static_cast<double>(buff->full_width),
+                              static_cast<double>(buff->full_height),
+                              0.0,
+                              1.0);
+    const auto centered_coord = buf_dim * 0.5 - vec4(x, y, 0.0, 0.0);
 
     // Recompute zoom matrix to discard its internal translation
     const auto zoom{1.0f / compute_zoom()};
@@ -381,17 +385,19 @@ vec4 Camera::get_position() const
     const auto buffer_obj = game_object_->stage->get_game_object("buffer");
 
     const auto buff = buffer_obj->get_component<Buffer>("buffer_component");
-    const auto buf_dim =
-        vec4(buff->buffer_width_f, buff->buffer_height_f, 0.0f, 1.0f);
-    const auto pos_vec = vec4{camera_pos_x_, camera_pos_y_, 0.0f, 1.0f};
+    const auto buf_dim = vec4(static_cast<double>(buff->full_width),
+                              static_cast<double>(buff->full_height),
+                              0.0,
+                              1.0);
+    const auto pos_vec = vec4{camera_pos_x_, camera_pos_y_, 0.0, 1.0};
 
-    return buf_dim * 0.5f - buffer_obj->get_pose().inv() * scale_ * pos_vec;
+    return buf_dim * 0.5 - buffer_obj->get_pose().inv() * scale_ * pos_vec;
 }
 
 
 void Camera::recenter_camera()
 {
-    camera_pos_x_ = camera_pos_y_ = 0.0f;
+    camera_pos_x_ = camera_pos_y_ = 0.0;
 
     set_initial_zoom();
     update_object_pose();
@@ -401,8 +407,8 @@ void Camera::recenter_camera()
 void Camera::mouse_drag_event(const int mouse_x, const int mouse_y)
 {
     // Mouse is down. Update camera_pos_x_/camera_pos_y_
-    camera_pos_x_ += static_cast<float>(mouse_x);
-    camera_pos_y_ += static_cast<float>(mouse_y);
+    camera_pos_x_ += static_cast<double>(mouse_x);
+    camera_pos_y_ += static_cast<double>(mouse_y);
 
     update_object_pose();
 }
@@ -76,14 +76,15 @@ class Camera final : public Component
 
     [[nodiscard]] float compute_zoom() const;
 
-    void move_to(float x, float y);
+    void move_to(double x, double y);
 
     [[nodiscard]] vec4 get_position() const;
 
   private:
     void update_object_pose() const;
 
-    [[nodiscard]] std::pair<float, float> get_buffer_initial_dimensions() const;
+    [[nodiscard]] std::pair<double, double>
+    get_buffer_initial_dimensions() const;
 
     void scale_at(const vec4& center_ndc, float delta);
 
@@ -92,8 +93,11 @@ class Camera final : public Component
     void handle_key_events();
 
     float zoom_power_{0.0f};
-    float camera_pos_x_{0.0f};
-    float camera_pos_y_{0.0f};
+
+    // Kept in double precision, like the transforms they end up in, so that
+    // the camera can still move by single pixels across gigapixel buffers
+    double camera_pos_x_{0.0};
+    double camera_pos_y_{0.0};
 
     int canvas_width_{0};
     int canvas_height_{0};
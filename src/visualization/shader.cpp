@@ -117,6 +117,12 @@ bool ShaderProgram::create(const char* v_source,
 }
 
 
+GLint ShaderProgram::uniform_location(const std::string& name) const
+{
+    return static_cast<GLint>(uniforms_.at(name));
+}
+
+
 void ShaderProgram::uniform1i(const std::string& name, const int value) const
 {
     gl_canvas_->glUniform1i(static_cast<GLint>(uniforms_.at(name)), value);
@@ -131,6 +137,14 @@ void ShaderProgram::uniform2f(const std::string& name,
 }
 
 
+void ShaderProgram::uniform2f(const GLint location,
+                              const float x,
+                              const float y) const
+{
+    gl_canvas_->glUniform2f(location, x, y);
+}
+
+
 void ShaderProgram::uniform3fv(const std::string& name,
                                const int count,
                                const float* data) const
@@ -159,6 +173,15 @@ void ShaderProgram::uniform_matrix4fv(const std::string& name,
 }
 
 
+void ShaderProgram::uniform_matrix4fv(const GLint location,
+                                      const int count,
+                                      const GLboolean transpose,
+                                      const float* value) const
+{
+    gl_canvas_->glUniformMatrix4fv(location, count, transpose, value);
+}
+
+
 void ShaderProgram::use() const
 {
     gl_canvas_->glUseProgram(program_);
@@ -62,10 +62,14 @@ class ShaderProgram
                 const std::vector<std::string>& uniforms);
 
     // Uniform handlers
+    [[nodiscard]] GLint uniform_location(const std::string& name) const;
+
     void uniform1i(const std::string& name, int value) const;
 
     void uniform2f(const std::string& name, float x, float y) const;
 
+    void uniform2f(GLint location, float x, float y) const;
+
     void
     uniform3fv(const std::string& name, int count, const float* data) const;
 
@@ -77,6 +81,11 @@ class ShaderProgram
                            GLboolean transpose,
                            const float* value) const;
 
+    void uniform_matrix4fv(GLint location,
+                           int count,
+                           GLboolean transpose,
+                           const float* value) const;
+
     // Program utility
     void use() const;
 
@@ -56,13 +56,14 @@ Stage::Stage(MainWindow* main_window)
 
 
 bool Stage::initialize(const uint8_t* buffer,
-                       const int buffer_width_i,
-                       const int buffer_height_i,
+                       const std::int64_t buffer_width_i,
+                       const std::int64_t buffer_height_i,
                        const int channels,
                        const BufferType type,
-                       const int step,
+                       const std::int64_t step,
                        const std::string& pixel_layout,
-                       const bool transpose_buffer)
+                       const bool transpose_buffer,
+                       const BufferRegion& region)
 {
     const auto camera_obj = std::make_shared<GameObject>();
 
@@ -91,10 +92,15 @@ bool Stage::initialize(const uint8_t* buffer,
     buffer_component->buffer          = buffer;
     buffer_component->channels        = channels;
     buffer_component->type            = type;
-    buffer_component->buffer_width_f  = static_cast<float>(buffer_width_i);
-    buffer_component->buffer_height_f = static_cast<float>(buffer_height_i);
-    buffer_component->step            = step;
-    buffer_component->transpose       = transpose_buffer;
+    buffer_component->buffer_width_f =
+        static_cast<float>(region.sampled_width());
+    buffer_component->buffer_height_f =
+        static_cast<float>(region.sampled_height());
+    buffer_component->full_width  = buffer_width_i;
+    buffer_component->full_height = buffer_height_i;
+    buffer_component->region      = region;
+    buffer_component->step        = step;
+    buffer_component->transpose   = transpose_buffer;
     buffer_component->set_pixel_layout(pixel_layout);
     buffer_obj->add_component("buffer_component", buffer_component);
 
@@ -113,13 +119,14 @@ bool Stage::initialize(const uint8_t* buffer,
 
 
 bool Stage::buffer_update(const uint8_t* buffer,
-                          const int buffer_width_i,
-                          const int buffer_height_i,
+                          const std::int64_t buffer_width_i,
+                          const std::int64_t buffer_height_i,
                           const int channels,
                           const BufferType type,
-                          const int step,
+                          const std::int64_t step,
                           const std::string& pixel_layout,
-                          const bool transpose_buffer)
+                          const bool transpose_buffer,
+                          const BufferRegion& region)
 {
     const auto buffer_obj = all_game_objects["buffer"].get();
     const auto buffer_component =
@@ -128,10 +135,15 @@ bool Stage::buffer_update(const uint8_t* buffer,
     buffer_component->buffer          = buffer;
     buffer_component->channels        = channels;
     buffer_component->type            = type;
-    buffer_component->buffer_width_f  = static_cast<float>(buffer_width_i);
-    buffer_component->buffer_height_f = static_cast<float>(buffer_height_i);
-    buffer_component->step            = step;
-    buffer_component->transpose       = transpose_buffer;
+    buffer_component->buffer_width_f =
+        static_cast<float>(region.sampled_width());
+    buffer_component->buffer_height_f =
+        static_cast<float>(region.sampled_height());
+    buffer_component->full_width  = buffer_width_i;
+    buffer_component->full_height = buffer_height_i;
+    buffer_component->region      = region;
+    buffer_component->step        = step;
+    buffer_component->transpose   = transpose_buffer;
     buffer_component->set_pixel_layout(pixel_layout);
 
     for (const auto& game_obj_it : all_game_objects | std::views::values) {
@@ -257,7 +269,7 @@ EventProcessCode Stage::key_press_event(const int key_code) const
 }
 
 
-void Stage::go_to_pixel(const float x, const float y)
+void Stage::go_to_pixel(const double x, const double y)
 {
     const auto cam_obj = all_game_objects["camera"].get();
     const auto camera_component =
@@ -283,4 +295,40 @@ void Stage::set_icon_drawing_mode(const bool is_enabled)
     buffer_component->set_icon_drawing_mode(is_enabled);
 }
 
+
+bool Stage::collect_texture_upload() const
+{
+    const auto buffer_component = get_buffer_component();
+    return buffer_component != nullptr &&
+           buffer_component->collect_texture_upload();
+}
+
+
+bool Stage::is_texture_upload_pending() const
+{
+    const auto buffer_component = get_buffer_component();
+    return buffer_component != nullptr &&
+           buffer_component->is_texture_upload_pending();
+}
+
+
+void Stage::cancel_texture_upload() const
+{
+    if (const auto buffer_component = get_buffer_component();
+        buffer_component != nullptr) {
+        buffer_component->cancel_texture_upload();
+    }
+}
+
+
+Buffer* Stage::get_buffer_component() const
+{
+    const auto buffer_obj = all_game_objects.find("buffer");
+    if (buffer_obj == all_game_objects.end()) {
+        return nullptr;
+    }
+
+    return buffer_obj->second->get_component<Buffer>("buffer_component");
+}
+
 } // namespace oid
@@ -47,22 +47,24 @@ class Stage
     explicit Stage(MainWindow* main_window);
 
     bool initialize(const uint8_t* buffer,
-                    int buffer_width_i,
-                    int buffer_height_i,
+                    std::int64_t buffer_width_i,
+                    std::int64_t buffer_height_i,
                     int channels,
                     BufferType type,
-                    int step,
+                    std::int64_t step,
                     const std::string& pixel_layout,
-                    bool transpose_buffer);
+                    bool transpose_buffer,
+                    const BufferRegion& region);
 
     bool buffer_update(const uint8_t* buffer,
-                       int buffer_width_i,
-                       int buffer_height_i,
+                       std::int64_t buffer_width_i,
+                       std::int64_t buffer_height_i,
                        int channels,
                        BufferType type,
-                       int step,
+                       std::int64_t step,
                        const std::string& pixel_layout,
-                       bool transpose_buffer);
+                       bool transpose_buffer,
+                       const BufferRegion& region);
 
     GameObject* get_game_object(const std::string& tag);
 
@@ -80,13 +82,29 @@ class Stage
 
     [[nodiscard]] EventProcessCode key_press_event(int key_code) const;
 
-    void go_to_pixel(float x, float y);
+    void go_to_pixel(double x, double y);
 
     void set_icon_drawing_mode(bool is_enabled);
 
+    /**
+     * Display the buffer textures uploaded in the background, once done
+     * @return true if the stage needs to be drawn again
+     */
+    bool collect_texture_upload() const;
+
+    [[nodiscard]] bool is_texture_upload_pending() const;
+
+    /**
+     * Stop reading the buffer contents to upload them. Must be called before
+     * the contents are modified or freed.
+     */
+    void cancel_texture_upload() const;
+
   private:
     std::map<std::string, std::shared_ptr<GameObject>, std::less<>>
         all_game_objects{};
+
+    [[nodiscard]] Buffer* get_buffer_component() const;
 };
 } // namespace oid
 
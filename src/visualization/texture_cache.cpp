@@ -0,0 +1,115 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace oid
+{
+
+void TextureCache::set_budget(const std::size_t budget)
+{
+    budget_ = budget;
+}
+
+
+std::size_t TextureCache::get_budget() const
+{
+    return budget_;
+}
+
+
+void TextureCache::insert(const GLuint texture,
+                          const std::size_t size,
+                          std::function<void()> on_evicted)
+{
+    erase(texture);
+
+    entries_.push_front(Entry{.texture          = texture,
+                              .size             = size,
+                              .last_drawn_frame = frame_,
+                              .on_evicted       = std::move(on_evicted)});
+    entry_by_texture_[texture] = entries_.begin();
+    resident_size_ += size;
+}
+
+
+void TextureCache::erase(const GLuint texture)
+{
+    const auto entry = entry_by_texture_.find(texture);
+    if (entry == entry_by_texture_.end()) {
+        return;
+    }
+
+    resident_size_ -= entry->second->size;
+    entries_.erase(entry->second);
+    entry_by_texture_.erase(entry);
+}
+
+
+void TextureCache::touch(const GLuint texture)
+{
+    const auto entry = entry_by_texture_.find(texture);
+    if (entry == entry_by_texture_.end()) {
+        return;
+    }
+
+    entry->second->last_drawn_frame = frame_;
+    entries_.splice(entries_.begin(), entries_, entry->second);
+}
+
+
+void TextureCache::make_room(const std::size_t size)
+{
+    evict_down_to(budget_ - (std::min)(size, budget_));
+}
+
+
+void TextureCache::finish_frame()
+{
+    evict_down_to(budget_);
+
+    ++frame_;
+}
+
+
+void TextureCache::evict_down_to(const std::size_t resident_size)
+{
+    while (resident_size_ > resident_size && !entries_.empty() &&
+           entries_.back().last_drawn_frame != frame_) {
+        auto evicted = std::move(entries_.back());
+        resident_size_ -= evicted.size;
+        entry_by_texture_.erase(evicted.texture);
+        entries_.pop_back();
+
+        // The owner may insert or erase other textures in the meantime
+        evicted.on_evicted();
+    }
+}
+
+} // namespace oid
@@ -0,0 +1,117 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef TEXTURE_CACHE_H_
+#define TEXTURE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "GL/gl.h"
+
+namespace oid
+{
+
+/**
+ * Tracks the memory taken by the textures of all buffers, and evicts those
+ * least recently drawn once they exceed a budget. Textures are owned by
+ * whoever inserted them, who is told to release them when evicted.
+ */
+class TextureCache final
+{
+  public:
+    static constexpr std::size_t default_budget = std::size_t{1024} << 20;
+
+    /**
+     * @param budget memory the textures may take, in bytes
+     */
+    void set_budget(std::size_t budget);
+
+    [[nodiscard]] std::size_t get_budget() const;
+
+    /**
+     * Start tracking a texture, as drawn in the current frame
+     * @param size memory taken by the texture, in bytes
+     * @param on_evicted called once the texture is evicted, which the
+     *     caller should then delete
+     */
+    void insert(GLuint texture,
+                std::size_t size,
+                std::function<void()> on_evicted);
+
+    /**
+     * Stop tracking a texture, without evicting it
+     */
+    void erase(GLuint texture);
+
+    /**
+     * Mark a texture as drawn in the current frame
+     */
+    void touch(GLuint texture);
+
+    /**
+     * Evict the textures least recently drawn until a new texture of the
+     * given size fits the budget along with the others. Those drawn in the
+     * current frame are kept regardless, since they are visible.
+     */
+    void make_room(std::size_t size);
+
+    /**
+     * Evict the textures least recently drawn until they fit the budget.
+     * Those drawn in the frame being finished are kept regardless, since
+     * they are visible.
+     */
+    void finish_frame();
+
+  private:
+    struct Entry
+    {
+        GLuint texture{};
+        std::size_t size{};
+        std::uint64_t last_drawn_frame{};
+        std::function<void()> on_evicted{};
+    };
+
+    // Most recently drawn first
+    std::list<Entry> entries_{};
+    std::unordered_map<GLuint, std::list<Entry>::iterator> entry_by_texture_{};
+
+    std::size_t budget_{default_budget};
+    std::size_t resident_size_{};
+    std::uint64_t frame_{};
+
+    /**
+     * Evict the textures not drawn in the current frame, least recently
+     * drawn first, until at most the given size remains resident
+     */
+    void evict_down_to(std::size_t resident_size);
+};
+
+} // namespace oid
+
+#endif // TEXTURE_CACHE_H_
@@ -0,0 +1,379 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "texture_uploader.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include "ipc/buffer_tiles.h"
+
+
+namespace oid
+{
+
+namespace
+{
+
+// Fences are waited on in slices, so that cancelled uploads are noticed
+constexpr auto fence_wait_nsecs = GLuint64{1'000'000};
+
+const std::uint8_t* get_tile_source(const TextureUploadRequest& request,
+                                    const TextureTile& tile)
+{
+    return request.pixels +
+           (tile.y * request.row_length + tile.x) * request.pixel_size;
+}
+
+} // namespace
+
+
+std::uint64_t hash_tile_pixels(const TextureUploadRequest& request,
+                               const TextureTile& tile)
+{
+    const auto row_size =
+        static_cast<std::size_t>(tile.width) * request.pixel_size;
+    const auto source_row_size =
+        static_cast<std::size_t>(request.row_length) * request.pixel_size;
+    const auto source = get_tile_source(request, tile);
+
+    // Rows are not contiguous in the source, so their hashes are hashed
+    auto row_hashes = std::vector<std::uint64_t>(tile.height);
+    for (int y = 0; y < tile.height; ++y) {
+        row_hashes[y] = hash_bytes(source + y * source_row_size, row_size);
+    }
+
+    return hash_bytes(std::bit_cast<const std::uint8_t*>(row_hashes.data()),
+                      row_hashes.size() * sizeof(std::uint64_t));
+}
+
+
+TextureUpload::TextureUpload(TextureUploadRequest request)
+    : request_{std::move(request)}
+{
+}
+
+
+bool TextureUpload::is_complete() const
+{
+    const auto lock = std::scoped_lock{state_mutex_};
+    return state_ == State::Complete;
+}
+
+
+void TextureUpload::cancel()
+{
+    is_cancel_requested_ = true;
+
+    auto lock = std::unique_lock{state_mutex_};
+    state_changed_.wait(lock, [this] { return state_ != State::Reading; });
+}
+
+
+std::vector<TextureTile> TextureUpload::take_tiles()
+{
+    const auto lock = std::scoped_lock{state_mutex_};
+    assert(state_ != State::Reading);
+
+    return std::move(request_.tiles);
+}
+
+
+bool TextureUpload::start_reading()
+{
+    const auto lock = std::scoped_lock{state_mutex_};
+    state_ = is_cancel_requested_ ? State::Cancelled : State::Reading;
+
+    return state_ == State::Reading;
+}
+
+
+bool TextureUpload::finish_reading()
+{
+    {
+        const auto lock = std::scoped_lock{state_mutex_};
+        state_ = is_cancel_requested_ ? State::Cancelled : State::Transferring;
+    }
+    state_changed_.notify_all();
+
+    return !is_cancel_requested_;
+}
+
+
+void TextureUpload::complete()
+{
+    {
+        // Tiles may have been taken by a cancellation in the meantime
+        const auto lock = std::scoped_lock{state_mutex_};
+        if (is_cancel_requested_) {
+            state_ = State::Cancelled;
+        } else {
+            for (auto& tile : request_.tiles) {
+                tile.is_uploaded = true;
+            }
+            state_ = State::Complete;
+        }
+    }
+    state_changed_.notify_all();
+}
+
+
+void TextureUpload::set_state(const State state)
+{
+    {
+        const auto lock = std::scoped_lock{state_mutex_};
+        state_          = state;
+    }
+    state_changed_.notify_all();
+}
+
+
+TextureUploader::~TextureUploader()
+{
+    {
+        const auto lock    = std::scoped_lock{uploads_mutex_};
+        is_stop_requested_ = true;
+    }
+    uploads_queued_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+
+bool TextureUploader::initialize(QOpenGLContext* shared_context)
+{
+    // Pixel buffer objects are core since 2.1, mapped ranges since 3.0 and
+    // fences since 3.2
+    const auto version  = shared_context->format().version();
+    const auto has_sync = version >= qMakePair(3, 2) ||
+                          shared_context->hasExtension("GL_ARB_sync");
+    const auto has_map_range =
+        version >= qMakePair(3, 0) ||
+        shared_context->hasExtension("GL_ARB_map_buffer_range");
+
+    if (!QOpenGLContext::supportsThreadedOpenGL() || !has_sync ||
+        !has_map_range) {
+        return false;
+    }
+
+    // Surfaces must be created on the GUI thread
+    surface_ = std::make_unique<QOffscreenSurface>();
+    surface_->setFormat(shared_context->format());
+    surface_->create();
+
+    auto is_created = std::promise<bool>{};
+    auto is_created_result = is_created.get_future();
+    thread_ = std::thread{
+        &TextureUploader::run, this, shared_context, std::move(is_created)};
+
+    is_available_ = is_created_result.get();
+
+    return is_available_;
+}
+
+
+bool TextureUploader::is_available() const
+{
+    return is_available_;
+}
+
+
+std::shared_ptr<TextureUpload>
+TextureUploader::upload(TextureUploadRequest request)
+{
+    auto upload = std::shared_ptr<TextureUpload>{
+        new TextureUpload{std::move(request)}};
+
+    {
+        const auto lock = std::scoped_lock{uploads_mutex_};
+        uploads_.push_back(upload);
+    }
+    uploads_queued_.notify_one();
+
+    return upload;
+}
+
+
+std::shared_ptr<TextureUpload> TextureUploader::wait_for_upload()
+{
+    auto lock = std::unique_lock{uploads_mutex_};
+    uploads_queued_.wait(
+        lock, [this] { return is_stop_requested_ || !uploads_.empty(); });
+
+    if (is_stop_requested_) {
+        return nullptr;
+    }
+
+    auto upload = std::move(uploads_.front());
+    uploads_.pop_front();
+
+    return upload;
+}
+
+
+void TextureUploader::run(QOpenGLContext* shared_context,
+                          std::promise<bool> is_created)
+{
+    // The context is created here, so that it belongs to this thread
+    auto context = QOpenGLContext{};
+    context.setFormat(shared_context->format());
+    context.setShareContext(shared_context);
+    if (!context.create() || !context.makeCurrent(surface_.get())) {
+        is_created.set_value(false);
+        return;
+    }
+    is_created.set_value(true);
+
+    const auto gl = context.extraFunctions();
+
+    auto pixel_buffers = std::array<GLuint, num_pixel_buffers>{};
+    gl->glGenBuffers(static_cast<GLsizei>(pixel_buffers.size()),
+                     pixel_buffers.data());
+    auto next_pixel_buffer = std::size_t{0};
+
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    while (const auto upload = wait_for_upload()) {
+        if (!upload->start_reading()) {
+            continue;
+        }
+
+        // Only tiles whose pixels changed are part of the request
+        const auto& request = upload->request_;
+        for (const auto& tile : request.tiles) {
+            if (upload->is_cancel_requested_) {
+                break;
+            }
+
+            const auto row_size =
+                static_cast<std::size_t>(tile.width) * request.pixel_size;
+            const auto tile_size = row_size * tile.height;
+            const auto source_row_size =
+                static_cast<std::size_t>(request.row_length) *
+                request.pixel_size;
+            const auto source = get_tile_source(request, tile);
+
+            gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER,
+                             pixel_buffers[next_pixel_buffer]);
+            next_pixel_buffer = (next_pixel_buffer + 1) % num_pixel_buffers;
+
+            // Orphan the previous storage, which may still be transferred
+            gl->glBufferData(GL_PIXEL_UNPACK_BUFFER,
+                             static_cast<GLsizeiptr>(tile_size),
+                             nullptr,
+                             GL_STREAM_DRAW);
+            const auto staging =
+                static_cast<std::uint8_t*>(gl->glMapBufferRange(
+                    GL_PIXEL_UNPACK_BUFFER,
+                    0,
+                    static_cast<GLsizeiptr>(tile_size),
+                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+            gl->glBindTexture(GL_TEXTURE_2D, tile.texture);
+
+            if (staging == nullptr) {
+                // Transfer from the source itself, which blocks this thread
+                // only
+                gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                gl->glPixelStorei(GL_UNPACK_ROW_LENGTH,
+                                  static_cast<GLint>(request.row_length));
+                gl->glTexSubImage2D(GL_TEXTURE_2D,
+                                    0,
+                                    0,
+                                    0,
+                                    tile.width,
+                                    tile.height,
+                                    request.format,
+                                    request.type,
+                                    source);
+                gl->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                if (request.has_mip_levels) {
+                    gl->glGenerateMipmap(GL_TEXTURE_2D);
+                }
+                continue;
+            }
+
+            for (int y = 0; y < tile.height; ++y) {
+                std::memcpy(staging + y * row_size,
+                            source + y * source_row_size,
+                            row_size);
+            }
+            gl->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+            gl->glTexSubImage2D(GL_TEXTURE_2D,
+                                0,
+                                0,
+                                0,
+                                tile.width,
+                                tile.height,
+                                request.format,
+                                request.type,
+                                nullptr);
+
+            // Reduce the tile on the GPU into the levels sampled when the
+            // buffer is zoomed out
+            if (request.has_mip_levels) {
+                gl->glGenerateMipmap(GL_TEXTURE_2D);
+            }
+        }
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (!upload->finish_reading()) {
+            continue;
+        }
+
+        // The canvas context sees the new contents once the transfer is over
+        // and it binds the textures again
+        const auto fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        auto status      = GLenum{GL_TIMEOUT_EXPIRED};
+        while (status == GL_TIMEOUT_EXPIRED &&
+               !upload->is_cancel_requested_) {
+            status = gl->glClientWaitSync(
+                fence, GL_SYNC_FLUSH_COMMANDS_BIT, fence_wait_nsecs);
+        }
+        gl->glDeleteSync(fence);
+
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            upload->complete();
+        } else {
+            upload->set_state(TextureUpload::State::Cancelled);
+        }
+    }
+
+    gl->glDeleteBuffers(static_cast<GLsizei>(pixel_buffers.size()),
+                        pixel_buffers.data());
+    context.doneCurrent();
+}
+
+} // namespace oid
@@ -0,0 +1,210 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef TEXTURE_UPLOADER_H_
+#define TEXTURE_UPLOADER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "GL/gl.h"
+
+class QOffscreenSurface;
+class QOpenGLContext;
+
+namespace oid
+{
+
+/**
+ * Part of a texture filled by an upload, in pixels of the source
+ */
+struct TextureTile
+{
+    GLuint texture{};
+    std::int64_t x{};
+    std::int64_t y{};
+    int width{};
+    int height{};
+
+    // Hash of the pixels the tile is filled with, computed before the upload
+    // is requested so that unchanged tiles are left out of it. is_uploaded is
+    // set once the upload completes.
+    std::optional<std::uint64_t> pixels_hash{};
+    bool is_uploaded{};
+};
+
+
+struct TextureUploadRequest
+{
+    const std::uint8_t* pixels{};
+    std::int64_t row_length{}; // Distance between rows, in pixels
+    int pixel_size{};          // In bytes
+    GLenum format{};
+    GLenum type{};
+    bool has_mip_levels{}; // Generated from the first level once uploaded
+    std::vector<TextureTile> tiles{};
+};
+
+
+/**
+ * Hash of the source pixels of a tile, which tells whether the tile changed
+ * since it was last uploaded
+ */
+std::uint64_t hash_tile_pixels(const TextureUploadRequest& request,
+                               const TextureTile& tile);
+
+
+/**
+ * Progress of an upload, shared between the GUI thread and the worker
+ */
+class TextureUpload
+{
+  public:
+    /**
+     * @return true once the textures hold the uploaded pixels and can be
+     *     drawn by the canvas context
+     */
+    [[nodiscard]] bool is_complete() const;
+
+    /**
+     * Stop the upload, blocking until the worker no longer reads its source
+     * pixels, so that they can be modified or freed. Textures are left
+     * partially uploaded, and tiles as they were requested.
+     */
+    void cancel();
+
+    /**
+     * Tiles of the request, updated with the pixels their textures received
+     * if the upload is complete
+     */
+    [[nodiscard]] std::vector<TextureTile> take_tiles();
+
+  private:
+    friend class TextureUploader;
+
+    enum class State { Queued, Reading, Transferring, Complete, Cancelled };
+
+    TextureUploadRequest request_{};
+
+    State state_{State::Queued};
+    std::atomic<bool> is_cancel_requested_{false};
+
+    mutable std::mutex state_mutex_{};
+    std::condition_variable state_changed_{};
+
+    explicit TextureUpload(TextureUploadRequest request);
+
+    /**
+     * Worker side: start reading the source pixels
+     * @return false if the upload was cancelled in the meantime
+     */
+    [[nodiscard]] bool start_reading();
+
+    /**
+     * Worker side: stop reading the source pixels
+     * @return false if the upload was cancelled in the meantime
+     */
+    [[nodiscard]] bool finish_reading();
+
+    /**
+     * Worker side: once the transfer is over, mark the tiles as uploaded and
+     * complete the upload, unless it was cancelled
+     */
+    void complete();
+
+    void set_state(State state);
+};
+
+
+/**
+ * Uploads buffer contents to textures from a worker thread, which owns an
+ * OpenGL context shared with the canvas. Pixels are copied into pixel buffer
+ * objects, transferred from them to the textures, and the upload completes
+ * once a fence placed after the transfer signals. Neither rendering nor
+ * interaction on the GUI thread waits on transfers.
+ *
+ * Textures are written while the canvas may be drawing, so those of a request
+ * must not be drawn until its upload completes.
+ */
+class TextureUploader final
+{
+  public:
+    TextureUploader() = default;
+
+    TextureUploader(const TextureUploader&)            = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    ~TextureUploader();
+
+    /**
+     * Start the worker, with a context sharing objects with shared_context,
+     * which must be current
+     * @return false if the platform or the OpenGL version do not support
+     *     uploads from another thread, in which case textures must be filled
+     *     by the caller
+     */
+    bool initialize(QOpenGLContext* shared_context);
+
+    [[nodiscard]] bool is_available() const;
+
+    /**
+     * Queue an upload. The source pixels must not be modified or freed until
+     * the upload completes or is cancelled.
+     */
+    [[nodiscard]] std::shared_ptr<TextureUpload>
+    upload(TextureUploadRequest request);
+
+  private:
+    // Pixel buffer objects used in turn, so that copying pixels into one
+    // overlaps with the transfer from the other
+    static constexpr std::size_t num_pixel_buffers = 2;
+
+    std::unique_ptr<QOffscreenSurface> surface_{};
+
+    std::deque<std::shared_ptr<TextureUpload>> uploads_{};
+    std::mutex uploads_mutex_{};
+    std::condition_variable uploads_queued_{};
+
+    bool is_available_{false};
+    bool is_stop_requested_{false};
+
+    std::thread thread_{};
+
+    void run(QOpenGLContext* shared_context, std::promise<bool> is_created);
+
+    [[nodiscard]] std::shared_ptr<TextureUpload> wait_for_upload();
+};
+
+} // namespace oid
+
+#endif // TEXTURE_UPLOADER_H_
@@ -0,0 +1,80 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Checks that only the tiles of a buffer that changed between two plots are
+ * sent again
+ */
+
+#include <cstdint>
+
+#include <vector>
+
+#include "check.h"
+#include "ipc/buffer_tiles.h"
+
+
+int main()
+{
+    using namespace oid;
+
+    // Four whole tiles and a partial one
+    const auto length = 4 * buffer_tile_size + 100;
+    auto buffer       = std::vector<std::uint8_t>(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        buffer[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    const auto previous = hash_buffer_tiles(buffer.data(), length);
+    OID_CHECK(previous.size() == 5);
+    OID_CHECK(hash_buffer_tiles(buffer.data(), length) == previous);
+    OID_CHECK(find_changed_tiles(previous, previous, length).empty());
+
+    // Adjacent tiles are merged into one range, and the partial tile is not
+    // extended past the end of the buffer
+    buffer[buffer_tile_size + 5] ^= 1;
+    buffer[2 * buffer_tile_size] ^= 1;
+    buffer[length - 1] ^= 1;
+
+    const auto current = hash_buffer_tiles(buffer.data(), length);
+    OID_CHECK(current[0] == previous[0]);
+    OID_CHECK(current[3] == previous[3]);
+
+    const auto changed = find_changed_tiles(previous, current, length);
+    OID_CHECK(changed.size() == 2);
+    if (changed.size() == 2) {
+        OID_CHECK(changed[0].offset == buffer_tile_size);
+        OID_CHECK(changed[0].length == 2 * buffer_tile_size);
+        OID_CHECK(changed[1].offset == 4 * buffer_tile_size);
+        OID_CHECK(changed[1].length == 100);
+    }
+
+    // Hashes depend on both contents and length
+    const auto data = std::vector<std::uint8_t>(64, 0);
+    OID_CHECK(hash_bytes(data.data(), 32) != hash_bytes(data.data(), 64));
+    OID_CHECK(hash_buffer_tiles(data.data(), 0).empty());
+
+    return oid::test::result();
+}
@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef TESTS_CHECK_H_
+#define TESTS_CHECK_H_
+
+#include <iostream>
+
+namespace oid::test
+{
+
+inline int failed_checks = 0;
+
+inline void
+check(const bool is_passed, const char* condition, const char* file, int line)
+{
+    if (!is_passed) {
+        std::cerr << file << ":" << line << ": check failed: " << condition
+                  << std::endl;
+        ++failed_checks;
+    }
+}
+
+/**
+ * Exit code of a test, once all its checks ran
+ */
+inline int result()
+{
+    return failed_checks == 0 ? 0 : 1;
+}
+
+} // namespace oid::test
+
+#define OID_CHECK(condition) \
+    oid::test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // TESTS_CHECK_H_
@@ -0,0 +1,159 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Checks that frames trickling in through a socket are assembled across calls
+ * to FrameAssembler::receive, resuming wherever the previous call stopped
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include <iostream>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "check.h"
+#include "ipc/message_exchange.h"
+
+namespace
+{
+
+constexpr auto timeout_msecs = 5000;
+
+
+/**
+ * Write some bytes from one end of a connection, and wait for them to be
+ * readable from the other
+ */
+bool transfer(QTcpSocket& writer,
+              QTcpSocket& reader,
+              const std::uint8_t* data,
+              const std::size_t size)
+{
+    const auto available = reader.bytesAvailable();
+
+    writer.write(reinterpret_cast<const char*>(data),
+                 static_cast<qint64>(size));
+    if (!writer.waitForBytesWritten(timeout_msecs)) {
+        return false;
+    }
+
+    while (reader.bytesAvailable() < available + static_cast<qint64>(size)) {
+        if (!reader.waitForReadyRead(timeout_msecs)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Length-prefixed frame, as written by MessageComposer
+ */
+std::vector<std::uint8_t> make_frame(const std::vector<std::uint8_t>& body)
+{
+    const auto length = body.size();
+
+    auto frame = std::vector<std::uint8_t>(sizeof(length));
+    std::memcpy(frame.data(), &length, sizeof(length));
+    frame.insert(frame.end(), body.begin(), body.end());
+
+    return frame;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    using namespace oid;
+
+    const auto app = QCoreApplication{argc, argv};
+
+    auto server = QTcpServer{};
+    if (!server.listen(QHostAddress::LocalHost)) {
+        std::cerr << "could not listen on the loopback interface" << std::endl;
+        return 1;
+    }
+
+    auto client = QTcpSocket{};
+    client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    if (!client.waitForConnected(timeout_msecs) ||
+        !server.waitForNewConnection(timeout_msecs)) {
+        std::cerr << "could not connect to the server" << std::endl;
+        return 1;
+    }
+    auto* const peer = server.nextPendingConnection();
+
+    auto body = std::vector<std::uint8_t>(1000);
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<std::uint8_t>(i);
+    }
+    const auto frame = make_frame(body);
+
+    auto assembler = FrameAssembler{};
+    auto received  = MessageFrame{};
+
+    // Nothing to read yet
+    OID_CHECK(!assembler.receive(peer, received));
+
+    // Split within the length prefix, then within the body
+    const auto splits = std::vector<std::size_t>{0, 3, 8, 500, frame.size()};
+    for (std::size_t i = 1; i < splits.size(); ++i) {
+        OID_CHECK(transfer(client,
+                           *peer,
+                           frame.data() + splits[i - 1],
+                           splits[i] - splits[i - 1]));
+
+        const auto is_complete = assembler.receive(peer, received);
+        OID_CHECK(is_complete == (i + 1 == splits.size()));
+    }
+
+    OID_CHECK(received.size == body.size());
+    OID_CHECK(received.data != nullptr &&
+              std::memcmp(received.data.get(), body.data(), body.size()) == 0);
+
+    // Back to back frames are returned one per call, the first one without
+    // reading into the second
+    const auto empty_frame = make_frame({});
+    auto frames            = empty_frame;
+    frames.insert(frames.end(), frame.begin(), frame.end());
+    OID_CHECK(transfer(client, *peer, frames.data(), frames.size()));
+
+    OID_CHECK(assembler.receive(peer, received));
+    OID_CHECK(received.size == 0);
+    OID_CHECK(peer->bytesAvailable() == static_cast<qint64>(frame.size()));
+
+    OID_CHECK(assembler.receive(peer, received));
+    OID_CHECK(received.size == body.size());
+
+    return oid::test::result();
+}
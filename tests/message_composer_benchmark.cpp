@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Measures the cost of composing the header of a plot message, and checks
+ * that it never touches the heap
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "check.h"
+#include "ipc/message_exchange.h"
+
+namespace
+{
+
+std::atomic<std::size_t> allocation_count{0};
+
+constexpr auto iterations = 1'000'000;
+
+
+/**
+ * Keep the compiler from optimizing away a composed message
+ */
+void escape(const void* object)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(object) : "memory");
+#else
+    static const void* volatile sink{};
+    sink = object;
+#endif
+}
+
+} // namespace
+
+
+void* operator new(const std::size_t size)
+{
+    ++allocation_count;
+    if (const auto memory = std::malloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+int main()
+{
+    using namespace oid;
+
+    // Strings short enough not to allocate when copied
+    const auto metadata = BufferMetadata{.variable_name = "image",
+                                         .display_name  = "image",
+                                         .pixel_layout  = "rgba",
+                                         .transpose     = false,
+                                         .width         = 1 << 20,
+                                         .height        = 1 << 20,
+                                         .channels      = 4,
+                                         .stride        = 1 << 20,
+                                         .type          = BufferType::Float32};
+    const auto region = BufferRegion{.x            = 0,
+                                     .y            = 0,
+                                     .width        = 4096,
+                                     .height       = 4096,
+                                     .downsampling = 256};
+
+    const auto allocations_before = allocation_count.load();
+    const auto start              = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i) {
+        auto message_composer = MessageComposer{};
+        message_composer.push(MessageType::PlotBufferRegionRequest)
+            .push(metadata)
+            .push(region);
+        escape(&message_composer);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto allocations = allocation_count.load() - allocations_before;
+
+    std::cout << "Composed " << iterations << " messages without payload in "
+              << std::chrono::duration<double, std::milli>(elapsed).count()
+              << " ms ("
+              << std::chrono::duration<double, std::nano>(elapsed).count() /
+                     iterations
+              << " ns each), " << allocations << " heap allocations"
+              << std::endl;
+
+    OID_CHECK(allocations == 0);
+
+    return oid::test::result();
+}
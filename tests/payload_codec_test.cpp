@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Checks that payloads survive a round trip through the ShuffleLz codec, and
+ * that malformed chunks are rejected
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "ipc/payload_codec.h"
+
+namespace
+{
+
+std::vector<oid::CompressedChunkView>
+get_views(const std::vector<oid::CompressedChunk>& chunks)
+{
+    auto views = std::vector<oid::CompressedChunkView>{};
+    for (const auto& chunk : chunks) {
+        views.push_back({chunk.raw_size, chunk.data.data(), chunk.data.size()});
+    }
+
+    return views;
+}
+
+
+bool is_round_trip_exact(const std::vector<std::uint8_t>& payload,
+                         const std::size_t element_size)
+{
+    const auto chunks =
+        oid::compress_payload(payload.data(), payload.size(), element_size);
+
+    auto decompressed = std::vector<std::uint8_t>(payload.size());
+    return oid::decompress_payload(get_views(chunks),
+                                   element_size,
+                                   decompressed.data(),
+                                   decompressed.size()) &&
+           decompressed == payload;
+}
+
+
+/**
+ * Smooth gradient of floats, which compresses well once shuffled
+ */
+std::vector<std::uint8_t> make_gradient(const std::size_t element_count)
+{
+    auto payload = std::vector<std::uint8_t>(element_count * sizeof(float));
+    for (std::size_t i = 0; i < element_count; ++i) {
+        const auto value = static_cast<float>(i % 4096) / 4096.0f;
+        std::memcpy(payload.data() + i * sizeof(float), &value, sizeof(float));
+    }
+
+    return payload;
+}
+
+
+std::vector<std::uint8_t> make_noise(const std::size_t length)
+{
+    auto generator = std::mt19937{42};
+    auto payload   = std::vector<std::uint8_t>(length);
+    for (auto& byte : payload) {
+        byte = static_cast<std::uint8_t>(generator());
+    }
+
+    return payload;
+}
+
+} // namespace
+
+
+int main()
+{
+    using namespace oid;
+
+    // Compressible payload spanning several chunks, the last one partial
+    const auto gradient =
+        make_gradient((2 * payload_codec_chunk_size + 1000) / sizeof(float));
+    OID_CHECK(is_round_trip_exact(gradient, sizeof(float)));
+
+    const auto gradient_chunks =
+        compress_payload(gradient.data(), gradient.size(), sizeof(float));
+    OID_CHECK(gradient_chunks.size() == 3);
+
+    auto compressed_size = std::size_t{0};
+    for (const auto& chunk : gradient_chunks) {
+        compressed_size += chunk.data.size();
+    }
+    OID_CHECK(compressed_size < gradient.size() / 2);
+
+    // Incompressible payloads are stored as is
+    const auto noise = make_noise(payload_codec_chunk_size / 2);
+    OID_CHECK(is_round_trip_exact(noise, 1));
+
+    const auto noise_chunks = compress_payload(noise.data(), noise.size(), 1);
+    OID_CHECK(noise_chunks.size() == 1);
+    OID_CHECK(noise_chunks.front().data.size() ==
+              noise_chunks.front().raw_size);
+
+    // Lengths that are not a multiple of the element size
+    OID_CHECK(is_round_trip_exact(make_noise(1001), sizeof(double)));
+    OID_CHECK(is_round_trip_exact({}, sizeof(float)));
+
+    // Chunks must fill the destination exactly
+    auto decompressed = std::vector<std::uint8_t>(gradient.size() + 1);
+    OID_CHECK(!decompress_payload(get_views(gradient_chunks),
+                                  sizeof(float),
+                                  decompressed.data(),
+                                  decompressed.size()));
+
+    // Truncated compressed data
+    auto truncated_views = get_views(gradient_chunks);
+    truncated_views.front().size /= 2;
+    decompressed.resize(gradient.size());
+    OID_CHECK(!decompress_payload(truncated_views,
+                                  sizeof(float),
+                                  decompressed.data(),
+                                  decompressed.size()));
+
+    return oid::test::result();
+}
@@ -0,0 +1,97 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2025 OpenImageDebugger contributors
+ * (https://github.com/OpenImageDebugger/OpenImageDebugger)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Checks that textures are evicted least recently drawn first, and never in
+ * the frame they were drawn
+ */
+
+#include <vector>
+
+#include "check.h"
+#include "visualization/texture_cache.h"
+
+
+int main()
+{
+    using namespace oid;
+
+    auto cache   = TextureCache{};
+    auto evicted = std::vector<GLuint>{};
+
+    const auto insert = [&](const GLuint texture) {
+        cache.insert(texture, 100, [&evicted, texture] {
+            evicted.push_back(texture);
+        });
+    };
+
+    cache.set_budget(300);
+    OID_CHECK(cache.get_budget() == 300);
+
+    // Textures drawn in the current frame are kept even over budget
+    for (GLuint texture = 1; texture <= 4; ++texture) {
+        insert(texture);
+    }
+    cache.finish_frame();
+    OID_CHECK(evicted.empty());
+
+    // Drawing a texture makes it the most recently used
+    cache.touch(1);
+    cache.touch(3);
+    cache.finish_frame();
+    OID_CHECK((evicted == std::vector<GLuint>{2}));
+
+    // Erased textures no longer count towards the budget, nor are evicted
+    cache.erase(4);
+    insert(5);
+    cache.finish_frame();
+    OID_CHECK((evicted == std::vector<GLuint>{2}));
+
+    insert(6);
+    cache.touch(5);
+    cache.finish_frame();
+    OID_CHECK((evicted == std::vector<GLuint>{2, 1}));
+
+    // Lowering the budget evicts down to it, least recently drawn first
+    cache.set_budget(100);
+    cache.touch(6);
+    cache.finish_frame();
+    OID_CHECK((evicted == std::vector<GLuint>{2, 1, 3, 5}));
+
+    // Room is made for new textures without waiting for the frame to end,
+    // still sparing those drawn in it
+    cache.set_budget(300);
+    insert(7);
+    insert(8);
+    cache.finish_frame();
+    cache.touch(8);
+    cache.make_room(200);
+    OID_CHECK((evicted == std::vector<GLuint>{2, 1, 3, 5, 6, 7}));
+
+    cache.make_room(1000);
+    OID_CHECK((evicted == std::vector<GLuint>{2, 1, 3, 5, 6, 7}));
+
+    return oid::test::result();
+}